@@ -0,0 +1,86 @@
+// Microbenchmark for GatherLaneBytes against the scalar path.
+//
+// Build from the repository root, with the AnalyzerSDK submodule checked out:
+//
+//	g++ -std=c++11 -O3 -I./AnalyzerSDK/include -I./source bench/QSPILaneGatherBench.cpp source/QSPILaneGather.cpp -o lane_gather_bench
+//
+// or without it, against the stand-in in test/MockAnalyzerSDK (-I./test/MockAnalyzerSDK/include).
+//
+// -O3 is the level the analyzer ships with (build_analyzer.py), and there GCC auto-vectorizes the
+// scalar loop, so the kernel mostly just matches it: with 1 MiB runs on an AVX2 machine, quad is
+// 1.01-1.30x scalar for SDR and 1.27-1.31x for DTR, and octal SDR can come out slightly slower.
+// Only at -O2, where the scalar loop stays scalar, is quad about 4x for SDR and 6-7x for DTR.
+//
+// Usage: lane_gather_bench [bytes per run] [runs]
+
+#include "QSPILaneGather.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+typedef void (*GatherFunction)( U32 line_mask, bool dtr, const U8* edge_lines, U32 byte_count, U8* bytes );
+
+static double TimeGather( GatherFunction gather, U32 line_mask, bool dtr, const std::vector<U8>& edge_lines, std::vector<U8>& bytes, U32 runs )
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for( U32 r = 0; r < runs; r++ )
+		gather( line_mask, dtr, &edge_lines[ 0 ], U32( bytes.size() ), &bytes[ 0 ] );
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double>( end - start ).count();
+}
+
+int main( int argc, char* argv[] )
+{
+	U32 byte_count = ( argc > 1 ) ? U32( strtoul( argv[ 1 ], NULL, 10 ) ) : 1 << 20;
+	U32 runs = ( argc > 2 ) ? U32( strtoul( argv[ 2 ], NULL, 10 ) ) : 100;
+
+	const U32 line_masks[] = { 0xFF, 0x0F, 0x03, 0x01 };
+	const U32 lines_used[] = { 8, 4, 2, 1 };
+
+	int result = 0;
+	for( U32 run = 0; run < 2 * sizeof( line_masks ) / sizeof( line_masks[ 0 ] ); run++ )
+	{
+		const U32 m = run / 2;
+		const bool dtr = ( run % 2 ) != 0;
+		const char* rate = dtr ? "DTR" : "SDR";
+
+		// random line samples, including the lines outside the mask and the trailing edges,
+		// which the gather has to ignore
+		std::vector<U8> edge_lines( byte_count * 16 / lines_used[ m ] );
+		srand( 1 );
+		for( size_t i = 0; i < edge_lines.size(); i++ )
+			edge_lines[ i ] = U8( rand() );
+
+		// odd lengths exercise the scalar tail after the vector loop
+		for( U32 length = 1; length < 100; length++ )
+		{
+			std::vector<U8> fast( length ), scalar( length );
+			GatherLaneBytes( line_masks[ m ], dtr, &edge_lines[ 0 ], length, &fast[ 0 ] );
+			GatherLaneBytesScalar( line_masks[ m ], dtr, &edge_lines[ 0 ], length, &scalar[ 0 ] );
+			if( fast != scalar )
+			{
+				printf( "mask 0x%02X %s: mismatch at %u bytes\n", line_masks[ m ], rate, length );
+				result = 1;
+			}
+		}
+
+		std::vector<U8> bytes( byte_count );
+		double fast_seconds = TimeGather( GatherLaneBytes, line_masks[ m ], dtr, edge_lines, bytes, runs );
+		std::vector<U8> fast_bytes = bytes;
+		double scalar_seconds = TimeGather( GatherLaneBytesScalar, line_masks[ m ], dtr, edge_lines, bytes, runs );
+		if( fast_bytes != bytes )
+		{
+			printf( "mask 0x%02X %s: mismatch\n", line_masks[ m ], rate );
+			result = 1;
+		}
+
+		double megabytes = double( byte_count ) * runs / 1e6;
+		printf( "mask 0x%02X %s: GatherLaneBytes %8.1f MB/s, scalar %8.1f MB/s, speedup %.2fx\n", line_masks[ m ], rate,
+				megabytes / fast_seconds, megabytes / scalar_seconds, scalar_seconds / fast_seconds );
+	}
+
+	return result;
+}
@@ -0,0 +1,119 @@
+// Benchmark for the text/csv export against the per-row stringstream export it replaced.
+//
+// The analyzer's own quad mode simulation data is decoded once, then both exports write the same
+// frames to a temporary file. The old export is kept here as it was: one stringstream per frame,
+// the SDK's time and number strings, and one AppendToFile per frame. It takes the frames as one
+// byte each, which they are with the default Data Bytes per Frame setting, and leaves out the
+// per-frame progress check, which is protected and does nothing in the stand-in.
+//
+// Build from the repository root, against the stand-in in test/MockAnalyzerSDK:
+//
+//	g++ -std=c++11 -O2 -I./test/MockAnalyzerSDK/include -I./source bench/QSPITextExportBench.cpp source/*.cpp test/MockAnalyzerSDK/source/*.cpp -o text_export_bench -lpthread
+//
+// The stand-in's file and string helpers are thin wrappers over stdio, so the times are those of
+// the analyzer's own code more than of the SDK's.
+//
+// Usage: text_export_bench [samples per capture] [runs] [export file]
+
+#include "QSPIAnalyzer.h"
+#include "QSPIAnalyzerSettings.h"
+#include "QSPIAnalyzerResults.h"
+#include <AnalyzerHelpers.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+class QSPIBenchAnalyzer : public QSPIAnalyzer
+{
+public:
+	QSPIAnalyzerSettings* GetSettings() { return mSettings.get(); }
+	QSPIAnalyzerResults* GetResults() { return mResults.get(); }
+};
+
+static void GenerateStringStreamExport( QSPIAnalyzerResults* results, const char* file, DisplayBase display_base, U64 trigger_sample, U32 sample_rate )
+{
+	std::stringstream ss;
+
+	U64 num_frames = results->GetNumFrames();
+
+	void* f = AnalyzerHelpers::StartFile( file );
+
+	ss << "Time [s],Value" << std::endl;
+
+	for( U32 i = 0; i < num_frames; i++ )
+	{
+		Frame frame = results->GetFrame( i );
+
+		char time_str[ 128 ];
+		AnalyzerHelpers::GetTimeString( frame.mStartingSampleInclusive, trigger_sample, sample_rate, time_str, 128 );
+
+		char number_str[ 128 ];
+		AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, 128 );
+
+		ss << time_str << "," << number_str << std::endl;
+
+		AnalyzerHelpers::AppendToFile( ( U8* )ss.str().c_str(), ss.str().length(), f );
+		ss.str( std::string() );
+	}
+
+	AnalyzerHelpers::EndFile( f );
+}
+
+static double Seconds( std::chrono::steady_clock::time_point start )
+{
+	return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+int main( int argc, char* argv[] )
+{
+	U64 sample_count = ( argc > 1 ) ? strtoull( argv[ 1 ], NULL, 10 ) : 60000000;
+	U32 runs = ( argc > 2 ) ? U32( strtoul( argv[ 2 ], NULL, 10 ) ) : 3;
+	const char* file = ( argc > 3 ) ? argv[ 3 ] : "text_export_bench.csv";
+	if( runs == 0 )
+		runs = 1;
+
+	QSPIBenchAnalyzer analyzer;
+	QSPIAnalyzerSettings* settings = analyzer.GetSettings();
+	settings->mEnableChannel = Channel( 0, 0 );
+	settings->mClockChannel = Channel( 0, 1 );
+	settings->mDQ0Channel = Channel( 0, 2 );
+	settings->mDQ1Channel = Channel( 0, 3 );
+	settings->mDQ2Channel = Channel( 0, 4 );
+	settings->mDQ3Channel = Channel( 0, 5 );
+	settings->mModeState = ModeStateQuad;
+	settings->UpdateInterfacesFromSettings();
+
+	analyzer.SetCaptureSampleRate( 100000000 );
+	analyzer.LoadSimulationCapture( sample_count );
+	analyzer.Run();
+
+	QSPIAnalyzerResults* results = analyzer.GetResults();
+	const U64 trigger_sample = analyzer.GetTriggerSample();
+	const U32 sample_rate = analyzer.GetSampleRate();
+
+	double old_seconds = 0.0;
+	double new_seconds = 0.0;
+	for( U32 r = 0; r < runs; r++ )
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		GenerateStringStreamExport( results, file, Hexadecimal, trigger_sample, sample_rate );
+		double seconds = Seconds( start );
+		if( ( r == 0 ) || ( seconds < old_seconds ) )
+			old_seconds = seconds;
+
+		start = std::chrono::steady_clock::now();
+		results->GenerateExportFile( file, Hexadecimal, 0 );
+		seconds = Seconds( start );
+		if( ( r == 0 ) || ( seconds < new_seconds ) )
+			new_seconds = seconds;
+	}
+	remove( file );
+
+	const U64 rows = results->GetNumFrames();
+	printf( "%llu rows, fastest of %u runs\n", rows, runs );
+	printf( "stringstream export %9.3f s %8.2f Mrows/s\n", old_seconds, double( rows ) / old_seconds / 1e6 );
+	printf( "buffered export     %9.3f s %8.2f Mrows/s  %.1fx\n", new_seconds, double( rows ) / new_seconds / 1e6, old_seconds / new_seconds );
+
+	return 0;
+}
@@ -0,0 +1,84 @@
+#include "QSPIAddressIndex.h"
+#include "QSPIFlashImage.h"
+#include <algorithm>
+
+QSPIAddressIndex::QSPIAddressIndex()
+:	mSortedCount(0)
+{
+}
+
+void QSPIAddressIndex::Clear()
+{
+	mRanges.clear();
+	mSortedCount = 0;
+	mMaxEnd.clear();
+}
+
+void QSPIAddressIndex::AddRange(U64 start, U64 end, U64 transaction_id)
+{
+	Range range = { start, end, transaction_id };
+	mRanges.push_back(range);
+}
+
+void QSPIAddressIndex::FindTransactions(U64 start, U64 end, std::vector<U64>& transaction_ids)
+{
+	transaction_ids.clear();
+	if (mSortedCount != mRanges.size())
+		Build();
+
+	// only ranges starting before end can overlap; among them the tree finds those ending after start
+	Range key = { end, 0, 0 };
+	const U32 limit = U32(std::lower_bound(mRanges.begin(), mRanges.end(), key) - mRanges.begin());
+	if ((limit > 0) && (start < end))
+		FindInTree(1, 0, U32(mMaxEnd.size() / 2), limit, start, transaction_ids);
+
+	std::sort(transaction_ids.begin(), transaction_ids.end());
+}
+
+bool QSPIAddressIndex::GetCommandRange(U8 command, const CommandAttr& attr, bool has_address, U64 address, U32 byte_count, U64& start, U64& end)
+{
+	if (attr.RegisterAddress == true)
+		return false;
+	if (QSPIFlashImage::GetEraseRange(command, has_address, address, start, end) == true)
+		return true;
+	if (has_address == false)
+		return false;
+
+	// an address without data still names the byte it points at
+	start = address;
+	end = address + std::max<U32>(byte_count, 1);
+	return true;
+}
+
+void QSPIAddressIndex::Build()
+{
+	std::stable_sort(mRanges.begin(), mRanges.end());
+	mSortedCount = U32(mRanges.size());
+
+	U32 tree_size = 1;
+	while (tree_size < mSortedCount)
+		tree_size *= 2;
+	mMaxEnd.assign(2 * tree_size, 0);
+
+	for (U32 i = 0; i < mSortedCount; i++)
+		mMaxEnd[tree_size + i] = mRanges[i].mEnd;
+	for (U32 node = tree_size - 1; node > 0; node--)
+		mMaxEnd[node] = std::max(mMaxEnd[2 * node], mMaxEnd[2 * node + 1]);
+}
+
+void QSPIAddressIndex::FindInTree(U32 node, U32 first, U32 count, U32 limit, U64 start, std::vector<U64>& transaction_ids) const
+{
+	// node covers the sorted ranges first to first + count - 1; the padding leaves end at 0
+	if ((first >= limit) || (mMaxEnd[node] <= start))
+		return;
+
+	if (count == 1)
+	{
+		transaction_ids.push_back(mRanges[first].mTransaction);
+		return;
+	}
+
+	const U32 half = count / 2;
+	FindInTree(2 * node, first, half, limit, start, transaction_ids);
+	FindInTree(2 * node + 1, first + half, half, limit, start, transaction_ids);
+}
@@ -0,0 +1,45 @@
+#ifndef QSPI_ADDRESS_INDEX
+#define QSPI_ADDRESS_INDEX
+
+#include <LogicPublicTypes.h>
+#include <vector>
+#include "QSPIAnalyzerCommands.h"
+
+// Flash address ranges touched by each transaction, for "which transactions read, programmed or
+// erased this range" queries. Ranges are added in capture order. On the first query after an
+// addition, the index sorts them by start address and builds a tree of the largest end address
+// under each node, so a query costs O(log n) plus O(log n) per match.
+class QSPIAddressIndex
+{
+public:
+	QSPIAddressIndex();
+
+	void Clear();
+	void AddRange(U64 start, U64 end, U64 transaction_id); // the bytes start to end - 1
+
+	// ids of the transactions whose range overlaps start to end - 1, in ascending order
+	void FindTransactions(U64 start, U64 end, std::vector<U64>& transaction_ids);
+
+	// the range a command touches, from its address and data byte count; erase commands cover
+	// their whole granule (QSPIFlashImage::GetEraseRange). Returns false for no range, which
+	// includes the commands whose address is not in the flash array (CommandAttr::RegisterAddress).
+	static bool GetCommandRange(U8 command, const CommandAttr& attr, bool has_address, U64 address, U32 byte_count, U64& start, U64& end);
+
+protected:
+	struct Range
+	{
+		U64 mStart;
+		U64 mEnd;
+		U64 mTransaction;
+		bool operator<(const Range& other) const { return mStart < other.mStart; }
+	};
+
+	void Build();
+	void FindInTree(U32 node, U32 first, U32 count, U32 limit, U64 start, std::vector<U64>& transaction_ids) const;
+
+	std::vector<Range> mRanges; // sorted by start up to mSortedCount
+	U32 mSortedCount;
+	std::vector<U64> mMaxEnd; // implicit tree over the sorted ranges, root at 1
+};
+
+#endif //QSPI_ADDRESS_INDEX
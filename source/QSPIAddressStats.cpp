@@ -0,0 +1,158 @@
+#include "QSPIAddressStats.h"
+#include <algorithm>
+
+static const U64 ADDRESS_SPACE_END = 1ULL << 32;
+
+QSPIAddressStats::QSPIAddressStats(U64 heatmap_bucket_size)
+:	mBucketSize((heatmap_bucket_size != 0) ? heatmap_bucket_size : U64(SECTOR_SIZE)),
+	mReadBytes(0),
+	mProgramBytes(0),
+	mErases(0),
+	mChipErases(0)
+{
+}
+
+void QSPIAddressStats::AddRead(U64 start, U64 end)
+{
+	if (ClampRange(start, end) == false)
+		return;
+
+	mReadBytes += end - start;
+	AddSectorBytes(mSectorReadBytes, start, end);
+	AddHeat(start, end);
+}
+
+void QSPIAddressStats::AddProgram(U64 start, U64 end)
+{
+	if (ClampRange(start, end) == false)
+		return;
+
+	mProgramBytes += end - start;
+	AddSectorBytes(mSectorProgramBytes, start, end);
+	AddHeat(start, end);
+}
+
+void QSPIAddressStats::AddErase(U64 start, U64 end)
+{
+	if ((start == 0) && (end == ~U64(0)))
+	{
+		mChipErases++;
+		return;
+	}
+	if (ClampRange(start, end) == false)
+		return;
+
+	mErases++;
+	const U64 last = (end - 1) / SUBSECTOR_SIZE;
+	if (last >= mSubsectorErases.size())
+		mSubsectorErases.resize(last + 1, 0);
+	for (U64 subsector = start / SUBSECTOR_SIZE; subsector <= last; subsector++)
+		mSubsectorErases[subsector]++;
+
+	AddHeat(start, end);
+}
+
+void QSPIAddressStats::WriteSummary(QSPIExportWriter& writer) const
+{
+	writer.AddText("Read bytes,Programmed bytes,Erases,Chip erases");
+	writer.EndLine();
+	writer.AddNumber(mReadBytes, Decimal, 64);
+	writer.AddChar(',');
+	writer.AddNumber(mProgramBytes, Decimal, 64);
+	writer.AddChar(',');
+	writer.AddNumber(mErases, Decimal, 64);
+	writer.AddChar(',');
+	writer.AddNumber(mChipErases, Decimal, 64);
+	writer.EndLine();
+
+	writer.EndLine();
+	writer.AddText("Sector address,Read bytes,Programmed bytes");
+	writer.EndLine();
+	const size_t sector_count = std::max(mSectorReadBytes.size(), mSectorProgramBytes.size());
+	for (size_t sector = 0; sector < sector_count; sector++)
+	{
+		const U64 read_bytes = (sector < mSectorReadBytes.size()) ? mSectorReadBytes[sector] : 0;
+		const U64 program_bytes = (sector < mSectorProgramBytes.size()) ? mSectorProgramBytes[sector] : 0;
+		if ((read_bytes | program_bytes) == 0)
+			continue;
+
+		writer.AddNumber(sector * SECTOR_SIZE, Hexadecimal, 32);
+		writer.AddChar(',');
+		writer.AddNumber(read_bytes, Decimal, 64);
+		writer.AddChar(',');
+		writer.AddNumber(program_bytes, Decimal, 64);
+		writer.EndLine();
+	}
+
+	writer.EndLine();
+	writer.AddText("Subsector address,Erases");
+	writer.EndLine();
+	for (size_t subsector = 0; subsector < mSubsectorErases.size(); subsector++)
+	{
+		if (mSubsectorErases[subsector] == 0)
+			continue;
+
+		writer.AddNumber(subsector * SUBSECTOR_SIZE, Hexadecimal, 32);
+		writer.AddChar(',');
+		writer.AddNumber(mSubsectorErases[subsector], Decimal, 32);
+		writer.EndLine();
+	}
+
+	writer.EndLine();
+	writer.AddText("Bucket address [");
+	writer.AddNumber(mBucketSize, Decimal, 64);
+	writer.AddText(" bytes],Transactions");
+	writer.EndLine();
+	for (size_t bucket = 0; bucket < mHeatmap.size(); bucket++)
+	{
+		if (mHeatmap[bucket] == 0)
+			continue;
+
+		writer.AddNumber(bucket * mBucketSize, Hexadecimal, 32);
+		writer.AddChar(',');
+		writer.AddNumber(mHeatmap[bucket], Decimal, 64);
+		writer.EndLine();
+	}
+}
+
+bool QSPIAddressStats::ClampRange(U64& start, U64& end) const
+{
+	if (end > ADDRESS_SPACE_END)
+		end = ADDRESS_SPACE_END;
+
+	return start < end;
+}
+
+void QSPIAddressStats::AddSectorBytes(std::vector<U64>& sectors, U64 start, U64 end)
+{
+	const U64 last = (end - 1) / SECTOR_SIZE;
+	if (last >= sectors.size())
+		sectors.resize(last + 1, 0);
+
+	// split the range at the sector boundaries
+	for (U64 sector = start / SECTOR_SIZE; sector <= last; sector++)
+	{
+		const U64 sector_start = std::max(start, sector * SECTOR_SIZE);
+		const U64 sector_end = std::min(end, (sector + 1) * SECTOR_SIZE);
+		sectors[sector] += sector_end - sector_start;
+	}
+}
+
+void QSPIAddressStats::AddHeat(U64 start, U64 end)
+{
+	U64 last = (end - 1) / mBucketSize;
+	while (last >= MAX_HEATMAP_BUCKETS)
+	{
+		// merge neighbouring buckets to stay within the cap
+		for (size_t bucket = 0; bucket < mHeatmap.size(); bucket += 2)
+			mHeatmap[bucket / 2] = mHeatmap[bucket] + ((bucket + 1 < mHeatmap.size()) ? mHeatmap[bucket + 1] : 0);
+		mHeatmap.resize((mHeatmap.size() + 1) / 2);
+		mBucketSize *= 2;
+		last = (end - 1) / mBucketSize;
+	}
+	if (last >= mHeatmap.size())
+		mHeatmap.resize(last + 1, 0);
+
+	for (U64 bucket = start / mBucketSize; bucket <= last; bucket++)
+		mHeatmap[bucket]++;
+}
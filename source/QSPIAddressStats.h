@@ -0,0 +1,46 @@
+#ifndef QSPI_ADDRESS_STATS
+#define QSPI_ADDRESS_STATS
+
+#include <LogicPublicTypes.h>
+#include <vector>
+#include "QSPIExportWriter.h"
+
+// Running totals over the flash address space: read and programmed bytes per 64 KB sector, erases
+// per 4 KB subsector, and a heatmap of the transactions touching each bucket of the address
+// space (a transaction spanning buckets counts in each). The tables cover the lowest 4 GB, growing
+// up to the highest address seen, so they stay within a few MB whatever the capture length. The
+// heatmap is capped at MAX_HEATMAP_BUCKETS buckets; past that, neighbouring buckets are merged
+// and the bucket size doubles.
+class QSPIAddressStats
+{
+public:
+	enum { SECTOR_SIZE = 0x10000, SUBSECTOR_SIZE = 0x1000, MAX_HEATMAP_BUCKETS = 0x10000 };
+
+	QSPIAddressStats(U64 heatmap_bucket_size);
+
+	// the bytes start to end - 1
+	void AddRead(U64 start, U64 end);
+	void AddProgram(U64 start, U64 end);
+	void AddErase(U64 start, U64 end); // 0 to ~0 is a chip erase, counted on its own
+
+	// CSV sections: totals, sectors, subsectors and heatmap buckets, leaving out the empty rows
+	void WriteSummary(QSPIExportWriter& writer) const;
+
+protected:
+	bool ClampRange(U64& start, U64& end) const;
+	void AddSectorBytes(std::vector<U64>& sectors, U64 start, U64 end);
+	void AddHeat(U64 start, U64 end);
+
+	std::vector<U64> mSectorReadBytes;
+	std::vector<U64> mSectorProgramBytes;
+	std::vector<U32> mSubsectorErases;
+	std::vector<U64> mHeatmap; // transactions per bucket
+	U64 mBucketSize;
+
+	U64 mReadBytes;
+	U64 mProgramBytes;
+	U64 mErases;
+	U64 mChipErases;
+};
+
+#endif //QSPI_ADDRESS_STATS
@@ -2,18 +2,31 @@
 #include "QSPIAnalyzerSettings.h"
 #include "QSPIAnalyzerCommands.h"
 #include <AnalyzerChannelData.h>
+#include <thread>
+#include <algorithm>
 
 QSPIAnalyzer::QSPIAnalyzer()
 :	Analyzer2(),
 	mSettings( new QSPIAnalyzerSettings() ),
 	mSimulationInitilized( false ),
-	mDQ0(NULL),
-	mDQ1(NULL),
-	mDQ2(NULL),
-	mDQ3(NULL),
 	mClock(NULL),
-	mEnable(NULL)
+	mEnable(NULL),
+	mRecordArrows(false),
+	mPendingDataBytes(0),
+	mPendingDataLines(0),
+	mFramesSinceCommit(0),
+	mLastCommitSample(0),
+	mUseEdgeIndex(false),
+	mQueuedWindowsStart(0),
+	mQueuedWindowsEnd(0),
+	mMaxQueuedWindows(1),
+	mNextQueuedWindow(0),
+	mFrameParser(NULL),
+	mGlitchSamples(0)
 {
+	for (U32 i = 0; i < 8; i++)
+		mDQ[i] = NULL;
+
 	SetAnalyzerSettings( mSettings.get() );
 }
 
@@ -35,12 +48,20 @@ void QSPIAnalyzer::SetupResults()
 void QSPIAnalyzer::WorkerThread()
 {
 	Setup();
+	SelectDecoder();
+	mPendingDataBytes = 0;
+	mFramesSinceCommit = 0;
+	mLastCommitSample = 0;
+	mLastCapturedWindow = false;
+
+	if (mUseEdgeIndex == true)
+		DecodeIndexedWindows(); // does not return
 
 	AdvanceToActiveEnableEdgeWithCorrectClockPolarity();
 
 	for (; ; )
 	{
-		GetFrame();
+		mFrameParser(*this);
 		CheckIfThreadShouldExit();
 	}
 }
@@ -48,8 +69,12 @@ void QSPIAnalyzer::WorkerThread()
 
 void QSPIAnalyzer::AdvanceToActiveEnableEdgeWithCorrectClockPolarity()
 {
-	mResults->CommitPacketAndStartNewPacket();
-	mResults->CommitResults();
+	FlushPackedData();
+	QSPIClockStats::Summary clock;
+	mClockStats.GetSummary(clock);
+	mClockStats.Clear();
+	CloseOpenWindow(); // a transaction abandoned part way through the window
+	FinishTransaction(mWindowStart, mWindowEnd, mClock->GetSampleNumber(), clock);
 
 	AdvanceToActiveEnableEdge();
 
@@ -58,6 +83,15 @@ void QSPIAnalyzer::AdvanceToActiveEnableEdgeWithCorrectClockPolarity()
 		if (IsInitialClockPolarityCorrect() == true)  //if false, this function moves to the next active enable edge.
 			break;
 	}
+
+	mLastCapturedWindow = (mEnable != NULL) && (mWindowOpen == false) && (mEnable->DoMoreTransitionsExistInCurrentData() == false);
+}
+
+
+void QSPIAnalyzer::FinishTransaction(U64 window_start, U64 window_end, U64 sample, const QSPIClockStats::Summary& clock)
+{
+	mResults->CommitTransaction(window_start, window_end, clock);
+	CommitResultsIfDue(sample);
 }
 
 
@@ -65,27 +99,35 @@ void QSPIAnalyzer::Setup()
 {
 	mArrowMarker = AnalyzerResults::UpArrow;
 
-	if (mSettings->mDQ0Channel != UNDEFINED_CHANNEL)
-		mDQ0 = GetAnalyzerChannelData(mSettings->mDQ0Channel);
-	else
-		mDQ0 = NULL;
+	// one entry per clock of the longest field: a four byte address on one line, or the dummy
+	// cycles, which a profile can set up to 32
+	mArrowLocations.assign(std::max<U32>(32, mSettings->mDummyCycles), 0);
+	mRecordArrows = (mSettings->mMarkerDetail == MarkersOnErrors) || (mSettings->mMarkerDetail == MarkersEveryBit);
 
-	if (mSettings->mDQ1Channel != UNDEFINED_CHANNEL)
-		mDQ1 = GetAnalyzerChannelData(mSettings->mDQ1Channel);
-	else
-		mDQ1 = NULL;
+	Channel dq_channels[8] = { mSettings->mDQ0Channel, mSettings->mDQ1Channel, mSettings->mDQ2Channel, mSettings->mDQ3Channel,
+		mSettings->mDQ4Channel, mSettings->mDQ5Channel, mSettings->mDQ6Channel, mSettings->mDQ7Channel };
+	for (U32 i = 0; i < 8; i++)
+	{
+		if (dq_channels[i] != UNDEFINED_CHANNEL)
+			mDQ[i] = GetAnalyzerChannelData(dq_channels[i]);
+		else
+			mDQ[i] = NULL;
+	}
 
-	if (mSettings->mDQ2Channel != UNDEFINED_CHANNEL)
-		mDQ2 = GetAnalyzerChannelData(mSettings->mDQ2Channel);
-	else
-		mDQ2 = NULL;
+	mClock = GetAnalyzerChannelData(mSettings->mClockChannel);
 
-	if (mSettings->mDQ3Channel != UNDEFINED_CHANNEL)
-		mDQ3 = GetAnalyzerChannelData(mSettings->mDQ3Channel);
-	else
-		mDQ3 = NULL;
+	mCommands = mSettings->mCommands;
+	mSfdp.Reset();
+	mClockStats.Clear();
 
-	mClock = GetAnalyzerChannelData(mSettings->mClockChannel);
+	// pulses no longer than the filter are glitches; a filter shorter than one sample drops nothing
+	const U64 filter_samples = U64(mSettings->mClockGlitchFilter) * GetSampleRate() / 1000000000;
+	mGlitchSamples = (filter_samples != 0) ? filter_samples + 1 : 0;
+
+	mWindowStart = 0; // no window before the first one
+	mWindowEnd = 0;
+	mWindowOpen = false;
+	mResults->SetupBusMetrics(GetSampleRate());
 
 	if (mSettings->mEnableChannel != UNDEFINED_CHANNEL)
 		mEnable = GetAnalyzerChannelData(mSettings->mEnableChannel);
@@ -102,19 +144,36 @@ void QSPIAnalyzer::AdvanceToActiveEnableEdge()
 	{
 		if (mEnable->GetBitState() != BIT_LOW) // hard code to enable active low
 		{
-			mEnable->AdvanceToNextEdge();
+			AdvanceEnableToNextEdge();
 		}
 		else
 		{
-			mEnable->AdvanceToNextEdge();
-			mEnable->AdvanceToNextEdge();
+			AdvanceEnableToNextEdge();
+			AdvanceEnableToNextEdge();
 		}
 		mCurrentSample = mEnable->GetSampleNumber();
+		mWindowStart = mCurrentSample;
 		mClock->AdvanceToAbsPosition(mCurrentSample);
+
+		// Find the end of the window once, so the clock walk never has to look at enable. When it is
+		// not captured yet, as at the end of a capture or in the live view, the walk looks for it at
+		// each clock edge instead, so the frames before it are not held back.
+		mWindowOpen = (mEnable->DoMoreTransitionsExistInCurrentData() == false);
+		if (mWindowOpen == true)
+		{
+			mWindowEnd = ~U64(0);
+		}
+		else
+		{
+			mEnable->AdvanceToNextEdge();
+			mWindowEnd = mEnable->GetSampleNumber();
+		}
 	}
 	else
 	{
 		mCurrentSample = mClock->GetSampleNumber();
+		mWindowStart = ~U64(0); // no chip-select windows to measure
+		mWindowEnd = ~U64(0);
 	}
 }
 
@@ -128,22 +187,21 @@ bool QSPIAnalyzer::IsInitialClockPolarityCorrect()
 
 	if (mEnable != NULL)
 	{
+		CloseOpenWindow();
+
 		Frame error_frame;
 		error_frame.mStartingSampleInclusive = mCurrentSample;
-
-		mEnable->AdvanceToNextEdge();
-		mCurrentSample = mEnable->GetSampleNumber();
-
-		error_frame.mEndingSampleInclusive = mCurrentSample;
+		error_frame.mEndingSampleInclusive = mWindowEnd;
 		error_frame.mFlags = DISPLAY_AS_ERROR_FLAG;
-		mResults->AddFrame(error_frame);
-		mResults->CommitResults();
-		ReportProgress(error_frame.mEndingSampleInclusive);
+		mResults->AddTransactionFrame(error_frame);
+
+		const QSPIClockStats::Summary no_clock = { 0, 0, 0, 0 };
+		mResults->CommitTransaction(mCurrentSample, mWindowEnd, no_clock); // the window is a packet of its own
+		mFramesSinceCommit++;
+		CommitResultsIfDue(error_frame.mEndingSampleInclusive);
 
 		//move to the next active-going enable edge
-		mEnable->AdvanceToNextEdge();
-		mCurrentSample = mEnable->GetSampleNumber();
-		mClock->AdvanceToAbsPosition(mCurrentSample);
+		AdvanceToActiveEnableEdge();
 
 		return false;
 	}
@@ -157,460 +215,487 @@ bool QSPIAnalyzer::IsInitialClockPolarityCorrect()
 
 
 
-bool QSPIAnalyzer::IsParseResultError(QSPIAnalyzer::ParseResult result)
+inline bool QSPIAnalyzer::AdvanceClockInWindow()
 {
-	if (result.start >= 0 && result.end > result.start) {
-        return false;
-	}
-	else {
-        return true;
-	}
-}
-
-
-bool QSPIAnalyzer::WouldAdvancingTheClockToggleEnable()
-{
-	if (mEnable == NULL)
+	if (MoveClockToNextEdge() == false)
 		return false;
 
-	U64 next_edge = mClock->GetSampleOfNextEdge();
-	bool enable_will_toggle = mEnable->WouldAdvancingToAbsPositionCauseTransition(next_edge);
-
-	if (enable_will_toggle == false)
+	// one test per edge while the filter is off
+	if ((mGlitchSamples != 0) && (SkipClockGlitches() == false))
 		return false;
-	else
-		return true;
+
+	mClockStats.AddEdge(mCurrentSample);
+	return true;
 }
 
-void QSPIAnalyzer::GetFrame()
+inline bool QSPIAnalyzer::MoveClockToNextEdge()
 {
-	ParseResult currentCommand;
+	// moves the clock to its next edge, unless that edge is at or past the end of the enable window
+	if (mWindowOpen == true)
+		return MoveClockInOpenWindow();
 
-	CommandAttr currentCommandAttr;
+	if (mLastCapturedWindow == true)
+	{
+		// the clock may have no edge after this window, so ask about the captured part only rather than wait
+		if (mClock->WouldAdvancingToAbsPositionCauseTransition(mWindowEnd - 1) == false)
+			return false;
 
-	// Get Command
-	switch (mSettings->mModeState) {
-	case 1 : currentCommand = GetCommand(0x01); //Extended mode
-		break;
-	case 2 : currentCommand = GetCommand(0x03); //Dual mode
-		break;
-	case 3 : currentCommand = GetCommand(0x0F); //Quad mode
-		break;
+		mClock->AdvanceToNextEdge();
+		mCurrentSample = mClock->GetSampleNumber();
+		return true;
 	}
 
-	if(IsParseResultError(currentCommand)) {
-        return;
-    }
-    else {
-        SaveResults(currentCommand, FrameTypeCommand);
-
-        if (IsCommandValid(currentCommand.data)==false) { //if command byte is not valid, skip forward to end of active edge
-            AdvanceToActiveEnableEdgeWithCorrectClockPolarity();
-            return;
-        }
-    }
+	// without enable the walk has no window end to stop at, so it waits on the clock itself
+	if ((mEnable == NULL) && (mClock->DoMoreTransitionsExistInCurrentData() == false))
+		CommitResultsAndReportProgress(mCurrentSample);
 
-	currentCommandAttr = GetQSPICommandAttr(currentCommand.data);
+	U64 next_edge = mClock->GetSampleOfNextEdge();
+	if (next_edge >= mWindowEnd)
+		return false;
 
+	mClock->AdvanceToAbsPosition(next_edge);
+	mCurrentSample = next_edge;
+	return true;
+}
 
-	// Get Address
+bool QSPIAnalyzer::MoveClockInOpenWindow()
+{
+	// the window's end is not captured yet, so enable is checked at every clock edge as it comes in
+	if (mClock->DoMoreTransitionsExistInCurrentData() == false)
+		CommitResultsAndReportProgress(mCurrentSample);
 
-	if (currentCommandAttr.AcceptsAddr) {
-		ParseResult currentAddress;
+	U64 next_edge = mClock->GetSampleOfNextEdge();
+	if (mEnable->WouldAdvancingToAbsPositionCauseTransition(next_edge) == true)
+	{
+		CloseOpenWindow();
+		return false;
+	}
 
-		switch (mSettings->mModeState) {
-		case 1: currentAddress = GetAddress(currentCommandAttr.AddressLineMask); //Extended mode
-			break;
-		case 2: currentAddress = GetAddress(0x03); //Dual mode
-			break;
-		case 3: currentAddress = GetAddress(0x0F); //Quad mode
-			break;
-		}
-		
+	mClock->AdvanceToAbsPosition(next_edge);
+	mCurrentSample = next_edge;
+	return true;
+}
 
-		if(IsParseResultError(currentAddress)) {
-            return;
-		}
-        else {
-            SaveResults(currentAddress, FrameTypeAddress);
-        }
+void QSPIAnalyzer::CloseOpenWindow()
+{
+	if (mWindowOpen == false)
+		return;
 
-	}
+	AdvanceEnableToNextEdge();
+	mWindowEnd = mEnable->GetSampleNumber();
+	mWindowOpen = false;
+}
 
-	// Get Dummy bits
+bool QSPIAnalyzer::SkipClockGlitches()
+{
+	// A pulse that starts at mCurrentSample and ends within the filter is a glitch: both of its
+	// edges are dropped, and so are any glitches right after it.
+	for (; ; )
+	{
+		const U64 last_glitch_end = std::min(mCurrentSample + mGlitchSamples - 1, mWindowEnd - 1);
+		if (mClock->WouldAdvancingToAbsPositionCauseTransition(last_glitch_end) == false)
+			return true;
 
-	if (currentCommandAttr.UsesDummyCycles) {
-		ParseResult currentDummy;
-		currentDummy = GetDummy();
-		if(IsParseResultError(currentDummy)) {
-            return;
-		}
-        else {
-            SaveResults(currentDummy, FrameTypeDummy);
-        }
+		mClockStats.AddGlitch();
+		if (mSettings->mMarkerDetail != MarkersOff)
+			mResults->AddMarker(mCurrentSample, AnalyzerResults::ErrorX, mSettings->mClockChannel);
 
+		mClock->AdvanceToNextEdge(); // the end of the glitch, inside the window
+		if (MoveClockToNextEdge() == false)
+			return false;
 	}
+}
 
-	// Get Data
-	if (currentCommandAttr.HasData) {
-		for (;;) {
-			ParseResult currentData;
-
-			//currentData = GetData(currentCommandAttr.DataLineMask);
-			switch (mSettings->mModeState) {
-			case 1: currentData = GetData(currentCommandAttr.DataLineMask); //Extended mode
-				break;
-			case 2: currentData = GetData(0x03); //Dual mode
-				break;
-			case 3: currentData = GetData(0x0F); //Quad mode
-				break;
-			}
-
-            if(IsParseResultError(currentData)) {
-                return;
-            }
-            else {
-                SaveResults(currentData, FrameTypeData);
-            }
-		}
+void QSPIAnalyzer::AdvanceEnableToNextEdge()
+{
+	// The next enable edge may not be captured yet. Hand over everything decoded so far
+	// before the SDK makes us wait for it.
+	if (mEnable->DoMoreTransitionsExistInCurrentData() == false)
+	{
+		DecodeQueuedWindows();
+		CommitResultsAndReportProgress(mEnable->GetSampleNumber());
 	}
+
+	mEnable->AdvanceToNextEdge();
 }
 
-QSPIAnalyzer::ParseResult QSPIAnalyzer::GetDummy()
+void QSPIAnalyzer::SelectDecoder()
 {
+	// The two-pass decoders need chip-select windows, so without an enable line they fall back to streaming.
+	mUseEdgeIndex = (mSettings->mDecoder != DecoderStreaming) && (mEnable != NULL);
+	mFrameParser = QSPIFrameParser<QSPIAnalyzer>::Select(mSettings->mModeState, mSettings->mAddressSize);
+
+	U32 thread_count = 1;
+	if (mSettings->mDecoder == DecoderParallel)
+		thread_count = std::max(1U, std::thread::hardware_concurrency());
+
+	mWindowDecoders.resize(thread_count);
+	for (U32 i = 0; i < thread_count; i++)
+		mWindowDecoders[i].Setup(mSettings.get(), mGlitchSamples);
+
+	// the decode threads stay up between batches and runs; the caller is the first of them
+	mWorkers.Start(thread_count - 1, &QSPIAnalyzer::DecodeQueuedWindowsTask, this);
+
+	// enough windows per batch that handing them out is lost in the decode time
+	mMaxQueuedWindows = (thread_count > 1) ? thread_count * 64 : 1;
+	mQueuedFrames.resize(mMaxQueuedWindows);
+	mQueuedMarkers.resize(mMaxQueuedWindows);
+	mQueuedSfdpBytes.resize(mMaxQueuedWindows);
+	mQueuedClocks.resize(mMaxQueuedWindows);
+	mQueuedWindowsStart = 0;
+	mQueuedWindowsEnd = 0;
+}
 
-	QSPIAnalyzer::ParseResult return_value;
+void QSPIAnalyzer::AbandonTransaction()
+{
+	AdvanceToActiveEnableEdgeWithCorrectClockPolarity();
+}
 
+QSPIAnalyzer::ParseResult QSPIAnalyzer::GetDummy(U32 cycles)
+{
 
-	mArrowLocations.clear();
-	ReportProgress(mClock->GetSampleNumber());
+	QSPIAnalyzer::ParseResult return_value;
 
 	U64 first_sample = 0;
+	U64 last_sample = 0;
 
-	for (U32 i = 0; i<mSettings->mDummyCycles; i++)
+	for (U32 i = 0; i<cycles; i++)
 	{
-		//on every single edge, we need to check that enable doesn't toggle.
-		//note that we can't just advance the enable line to the next edge, becuase there may not be another edge
+		//a cycle cut short by the end of the enable window abandons the transaction
 
-		if (WouldAdvancingTheClockToggleEnable() == true)
-		{
-			AdvanceToActiveEnableEdgeWithCorrectClockPolarity();  //ok, we pretty much need to reset everything and return.
-			return{ -1,-1,0 }; // return values for error state
-		}
-
-		mClock->AdvanceToNextEdge(); // advance to rising edge
-		if (i == 0)
-			first_sample = mClock->GetSampleNumber();
+		if (AdvanceClockInWindow() == false) // advance to rising edge
+			return AbandonField(i, first_sample, last_sample);
 
 		//data valid on AnalyzerEnums::LeadingEdge of clock
-		mCurrentSample = mClock->GetSampleNumber();
-
-		mArrowLocations.push_back(mCurrentSample);
+		if (i == 0)
+			first_sample = mCurrentSample;
+		last_sample = mCurrentSample;
 
-		//this isn't the very last bit, etc, so proceed as normal
-		if (WouldAdvancingTheClockToggleEnable() == true)
-		{
-			AdvanceToActiveEnableEdgeWithCorrectClockPolarity();  //ok, we pretty much need to reset everything and return.
-			return{ -1,-1,0 }; // return values for error state
-		}
+		if (mRecordArrows == true)
+			mArrowLocations[i] = mCurrentSample;
 
-		mClock->AdvanceToNextEdge(); // advance to falling edge
+		if (AdvanceClockInWindow() == false) // advance to falling edge
+			return AbandonField(i + 1, first_sample, last_sample);
 	}
 
+	AddArrowMarkers(cycles, first_sample, last_sample, true);
+
 	return_value.start = first_sample;
-	return_value.end = mClock->GetSampleNumber();
+	return_value.end = mCurrentSample;
 	return_value.data = 0x00;
 
 	return return_value;
 
 }
 
-QSPIAnalyzer::ParseResult QSPIAnalyzer::GetData(U64 DataLineMask)
+QSPIAnalyzer::ParseResult QSPIAnalyzer::AbandonField(U32 bit_count, U64 first_sample, U64 last_sample)
 {
+	AddArrowMarkers(bit_count, first_sample, last_sample, false);
+	AdvanceToActiveEnableEdgeWithCorrectClockPolarity();  //ok, we pretty much need to reset everything and return.
+	return{ -1,-1,0 }; // return values for error state
+}
 
-	DataBuilder data_result;
-
-	U64 data_word = 0;
-	QSPIAnalyzer::ParseResult return_value;
-
-	data_result.Reset(&data_word, AnalyzerEnums::MsbFirst, 8); // todo: change 8 to bitspertransfer?
-
-
-	mArrowLocations.clear();
-	ReportProgress(mClock->GetSampleNumber());
-
-	U64 first_sample = 0;
-	//bool need_reset = false;
-
+void QSPIAnalyzer::AddArrowMarkers(U32 bit_count, U64 first_sample, U64 last_sample, bool complete)
+{
+	// fields cut short by chip select are marked at every level of detail but off
+	const U32 detail = mSettings->mMarkerDetail;
+	if ((detail == MarkersOff) || (bit_count == 0) || ((complete == true) && (detail == MarkersOnErrors)))
+		return;
 
-	// determine number of clock cycles needed
+	AnalyzerResults::MarkerType marker = complete ? mArrowMarker : AnalyzerResults::ErrorDot;
 
-	int lines_used = 0;
-	for (U32 i = 0; i < 4; i++) {
-		if (DataLineMask >> i & 0x01) {
-			lines_used++;
-		}
+	if (detail == MarkersFirstLast)
+	{
+		mResults->AddMarker(first_sample, marker, mSettings->mClockChannel);
+		if (last_sample != first_sample)
+			mResults->AddMarker(last_sample, marker, mSettings->mClockChannel);
 	}
-
-	for (U32 i = 0; i<(8/lines_used); i++)
+	else
 	{
-		//on every single edge, we need to check that enable doesn't toggle.
-		//note that we can't just advance the enable line to the next edge, becuase there may not be another edge
-
-		if (WouldAdvancingTheClockToggleEnable() == true)
-		{
-			AdvanceToActiveEnableEdgeWithCorrectClockPolarity();  //ok, we pretty much need to reset everything and return.
-			return{ -1,-1,0 }; // return values for error state
-		}
-
-		mClock->AdvanceToNextEdge(); // advance to rising edge
-		if (i == 0)
-			first_sample = mClock->GetSampleNumber();
-
-		//data valid on AnalyzerEnums::LeadingEdge of clock
-		mCurrentSample = mClock->GetSampleNumber();
-
-		if ((DataLineMask & 0x08) && (mDQ3 != NULL))
-		{
-			mDQ3->AdvanceToAbsPosition(mCurrentSample);
-			data_result.AddBit(mDQ3->GetBitState());
-		}
-		if ((DataLineMask & 0x04) && (mDQ2 != NULL))
-		{
-			mDQ2->AdvanceToAbsPosition(mCurrentSample);
-			data_result.AddBit(mDQ2->GetBitState());
-		}
-		if ((DataLineMask & 0x02) && (mDQ1 != NULL))
-		{
-			mDQ1->AdvanceToAbsPosition(mCurrentSample);
-			data_result.AddBit(mDQ1->GetBitState());
-		}
-		if ((DataLineMask & 0x01) && (mDQ0 != NULL))
-		{
-			mDQ0->AdvanceToAbsPosition(mCurrentSample);
-			data_result.AddBit(mDQ0->GetBitState());
-		}
-
-		mArrowLocations.push_back(mCurrentSample);
-
+		for (U32 i = 0; i < bit_count; i++)
+			mResults->AddMarker(mArrowLocations[i], marker, mSettings->mClockChannel);
+	}
+}
 
-		//this isn't the very last bit, etc, so proceed as normal
-		if (WouldAdvancingTheClockToggleEnable() == true)
+template <U32 LINE_MASK>
+inline U64 QSPIAnalyzer::GatherLines(U64 sample)
+{
+	// sample every line in the mask, highest line first, so the lines pack into one MsbFirst group
+	U64 lines = 0;
+	for (U32 line = 8; line-- > 0; )
+	{
+		if ((LINE_MASK >> line & 0x01) && (mDQ[line] != NULL))
 		{
-			AdvanceToActiveEnableEdgeWithCorrectClockPolarity();  //ok, we pretty much need to reset everything and return.
-			return{ -1,-1,0 }; // return values for error state
+			mDQ[line]->AdvanceToAbsPosition(sample);
+			lines |= U64(mDQ[line]->GetBitState()) << line;
 		}
-
-		mClock->AdvanceToNextEdge(); // advance to falling edge
 	}
 
-	return_value.start = first_sample;
-	return_value.end = mClock->GetSampleNumber();
-	return_value.data = data_word;
-
-	return return_value;
+	return lines >> LowestLine(LINE_MASK);
 }
 
-QSPIAnalyzer::ParseResult QSPIAnalyzer::GetAddress(U64 AddressLineMask)
+template <U32 LINE_MASK, bool DTR>
+QSPIAnalyzer::ParseResult QSPIAnalyzer::GetWord(U32 num_bits)
 {
+	const U32 lines_used = CountLines(LINE_MASK);
+	const U32 samples = num_bits / lines_used;
 
-	DataBuilder address_result;
-
-	U64 address_word = 0;
+	U64 word = 0;
 	QSPIAnalyzer::ParseResult return_value;
 
-	address_result.Reset(&address_word, AnalyzerEnums::MsbFirst, (mSettings->mAddressSize)*8); // todo: change 8 to bitspertransfer?
-
-
-	mArrowLocations.clear();
-	ReportProgress(mClock->GetSampleNumber());
-
 	U64 first_sample = 0;
-	//bool need_reset = false;
+	U64 last_sample = 0;
 
-
-	// determine number of clock cycles needed
-	int lines_used=0;
-	for (U32 i = 0; i < 4; i++) {
-		if (AddressLineMask >> i & 0x01) {
-			lines_used++;
-		}
-	}
-
-	for (U32 i = 0; i<((mSettings->mAddressSize) * 8/lines_used); i++)
+	for (U32 i = 0; i<samples; i++)
 	{
-		//on every single edge, we need to check that enable doesn't toggle.
-		//note that we can't just advance the enable line to the next edge, becuase there may not be another edge
+		//a cycle cut short by the end of the enable window abandons the transaction
 
-		if (WouldAdvancingTheClockToggleEnable() == true)
-		{
-			AdvanceToActiveEnableEdgeWithCorrectClockPolarity();  //ok, we pretty much need to reset everything and return.
-			return{ -1,-1,0 }; // return values for error state
-		}
+		if (AdvanceClockInWindow() == false) // advance to rising edge, or to the next edge for DTR
+			return AbandonField(i, first_sample, last_sample);
 
-		mClock->AdvanceToNextEdge(); // advance to rising edge
+		//SDR data valid on AnalyzerEnums::LeadingEdge of clock, DTR data on both edges
 		if (i == 0)
-			first_sample = mClock->GetSampleNumber();
+			first_sample = mCurrentSample;
+		last_sample = mCurrentSample;
 
-		//data valid on AnalyzerEnums::LeadingEdge of clock
-		mCurrentSample = mClock->GetSampleNumber();
+		// MsbFirst: earlier clocks end up in the higher bits of the word
+		word = (word << lines_used) | GatherLines<LINE_MASK>(mCurrentSample);
 
-		if ((AddressLineMask & 0x08) && (mDQ3 != NULL))
-		{
-			mDQ3->AdvanceToAbsPosition(mCurrentSample);
-			address_result.AddBit(mDQ3->GetBitState());
-		}
-		if ((AddressLineMask & 0x04) && (mDQ2 != NULL))
-		{
-			mDQ2->AdvanceToAbsPosition(mCurrentSample);
-			address_result.AddBit(mDQ2->GetBitState());
-		}
-		if ((AddressLineMask & 0x02) && (mDQ1 != NULL))
-		{
-			mDQ1->AdvanceToAbsPosition(mCurrentSample);
-			address_result.AddBit(mDQ1->GetBitState());
-		}
-		if ((AddressLineMask & 0x01) && (mDQ0 != NULL))
-		{
-			mDQ0->AdvanceToAbsPosition(mCurrentSample);
-			address_result.AddBit(mDQ0->GetBitState());
-		}
-
-		mArrowLocations.push_back(mCurrentSample);
+		if (mRecordArrows == true)
+			mArrowLocations[i] = mCurrentSample;
 
-
-		//this isn't the very last bit, etc, so proceed as normal
-		if (WouldAdvancingTheClockToggleEnable() == true)
-		{
-			AdvanceToActiveEnableEdgeWithCorrectClockPolarity();  //ok, we pretty much need to reset everything and return.
-			return{ -1,-1,0 }; // return values for error state
-		}
-
-		mClock->AdvanceToNextEdge(); // advance to falling edge
+		if ((DTR == false) && (AdvanceClockInWindow() == false)) // advance to falling edge
+			return AbandonField(i + 1, first_sample, last_sample);
 	}
 
+	AddArrowMarkers(samples, first_sample, last_sample, true);
+
 	return_value.start = first_sample;
-	return_value.end = mClock->GetSampleNumber();
-	return_value.data = address_word;
+	return_value.end = mCurrentSample;
+	return_value.data = word;
 
 	return return_value;
 }
 
-
-QSPIAnalyzer::ParseResult QSPIAnalyzer::GetCommand(U64 CommandLineMask)
+void QSPIAnalyzer::DecodeIndexedWindows()
 {
+	Channel dq_channels[8] = { mSettings->mDQ0Channel, mSettings->mDQ1Channel, mSettings->mDQ2Channel, mSettings->mDQ3Channel,
+		mSettings->mDQ4Channel, mSettings->mDQ5Channel, mSettings->mDQ6Channel, mSettings->mDQ7Channel };
+	mEdgeIndex.Reset(mSettings->mClockChannel, mSettings->mEnableChannel, dq_channels, 8); // the capture may have changed since the last run
 
-	DataBuilder command_result;
-
-	U64 command_word = 0;
-	QSPIAnalyzer::ParseResult return_value;
-
-	command_result.Reset(&command_word, AnalyzerEnums::MsbFirst, 8); // todo: change 8 to bitspertransfer?
+	AdvanceToActiveEnableEdge();
+	for (; ; )
+	{
+		while (mWindowOpen == true)
+			StreamOpenWindow();
 
-	mArrowLocations.clear();
-	ReportProgress(mClock->GetSampleNumber());
+		mEdgeIndex.AddWindow(mWindowStart, mWindowEnd, mClock, mDQ);
+		mQueuedWindowsEnd = mEdgeIndex.GetWindowCount();
 
-	U64 first_sample = 0;
-	//bool need_reset = false;
-	
-	// determine number of clock cycles needed
-	int lines_used = 0;
-	for (U32 i = 0; i < 4; i++) {
-		if (CommandLineMask >> i & 0x01) {
-			lines_used++;
+		if (mQueuedWindowsEnd - mQueuedWindowsStart >= mMaxQueuedWindows)
+		{
+			DecodeQueuedWindows();
+			CheckIfThreadShouldExit();
 		}
+
+		AdvanceToActiveEnableEdge(); // decodes the queued windows first if it has to wait
 	}
+}
 
-	
-	for (U32 i = 0; i<(8 / lines_used); i++)
-	{
-		//on every single edge, we need to check that enable doesn't toggle.
-		//note that we can't just advance the enable line to the next edge, becuase there may not be another edge
+void QSPIAnalyzer::StreamOpenWindow()
+{
+	// A window whose end is not captured yet cannot be indexed, so it goes through the streaming
+	// walk, after the windows queued before it. That walk ends in the next window.
+	DecodeQueuedWindows();
 
-		if (WouldAdvancingTheClockToggleEnable() == true)
-		{
-			AdvanceToActiveEnableEdgeWithCorrectClockPolarity();  //ok, we pretty much need to reset everything and return.
-			return {-1,-1,0}; // return values for error state
-		}
+	const U64 window_start = mWindowStart;
+	if (IsInitialClockPolarityCorrect() == false)
+		return;
 
-		mClock->AdvanceToNextEdge(); // advance to rising edge
-		if (i == 0)
-			first_sample = mClock->GetSampleNumber();
+	mLastCapturedWindow = false;
+	while (mWindowStart == window_start)
+	{
+		mFrameParser(*this);
+		CheckIfThreadShouldExit();
+	}
+}
 
-		//data valid on AnalyzerEnums::LeadingEdge of clock
-		mCurrentSample = mClock->GetSampleNumber();
+void QSPIAnalyzer::DecodeQueuedWindows()
+{
+	while (mQueuedWindowsStart < mQueuedWindowsEnd)
+	{
+		const U32 window_count = U32(mQueuedWindowsEnd - mQueuedWindowsStart);
 
+		// The channel cursors belong to this thread, so only the in-memory index is shared out: each
+		// worker takes the next queued window and decodes it into that window's frame list.
+		mNextQueuedWindow = 0;
+		mWorkers.RunBatch(std::min(mWorkers.GetWorkerCount(), window_count));
 
-		if ((CommandLineMask & 0x08) && (mDQ3 != NULL))
-		{
-			mDQ3->AdvanceToAbsPosition(mCurrentSample);
-			command_result.AddBit(mDQ3->GetBitState());
-		}
-		if ((CommandLineMask & 0x04) && (mDQ2 != NULL))
-		{
-			mDQ2->AdvanceToAbsPosition(mCurrentSample);
-			command_result.AddBit(mDQ2->GetBitState());
-		}
-		if ((CommandLineMask & 0x02) && (mDQ1 != NULL))
-		{
-			mDQ1->AdvanceToAbsPosition(mCurrentSample);
-			command_result.AddBit(mDQ1->GetBitState());
-		}
-		if ((CommandLineMask & 0x01) && (mDQ0 != NULL))
+		// windows are in capture order, so adding them one after the other keeps the frames sorted
+		U32 i = 0;
+		while (i < window_count)
 		{
-			mDQ0->AdvanceToAbsPosition(mCurrentSample);
-			command_result.AddBit(mDQ0->GetBitState());
+			const std::vector<QSPISfdp::Byte>& sfdp_bytes = mQueuedSfdpBytes[i];
+			const QSPIEdgeIndex::Window& window = mEdgeIndex.GetWindow(mQueuedWindowsStart + i);
+			if (window.mClockStartState != mSettings->mClockInactiveState)
+			{
+				// same handling as IsInitialClockPolarityCorrect: flag the whole window
+				mResults->AddMarker(window.mStart, AnalyzerResults::ErrorSquare, mSettings->mClockChannel);
+
+				Frame error_frame;
+				error_frame.mStartingSampleInclusive = window.mStart;
+				error_frame.mEndingSampleInclusive = window.mEnd;
+				error_frame.mFlags = DISPLAY_AS_ERROR_FLAG;
+				mResults->AddTransactionFrame(error_frame);
+				mFramesSinceCommit++;
+			}
+			else
+			{
+				const std::vector<Frame>& frames = mQueuedFrames[i];
+				for (U32 f = 0; f < frames.size(); f++)
+					mResults->AddTransactionFrame(frames[f]);
+				mFramesSinceCommit += frames.size();
+
+				const std::vector<QSPIWindowDecoder::Marker>& markers = mQueuedMarkers[i];
+				for (U32 m = 0; m < markers.size(); m++)
+					mResults->AddMarker(markers[m].mSample, markers[m].mType, mSettings->mClockChannel);
+			}
+
+			FinishTransaction(window.mStart, window.mEnd, window.mEnd, mQueuedClocks[i]);
+			i++;
+
+			// an SFDP read that changed the commands ends the batch, and the windows after it are decoded again
+			if (sfdp_bytes.empty() == false)
+			{
+				for (U32 b = 0; b < sfdp_bytes.size(); b++)
+					mSfdp.AddByte(sfdp_bytes[b].mAddress, sfdp_bytes[b].mData);
+
+				if (mSfdp.Configure(mCommands, mSettings->mModeState) == true)
+				{
+					for (U32 d = 0; d < mWindowDecoders.size(); d++)
+						mWindowDecoders[d].SetCommands(mCommands);
+					break;
+				}
+			}
 		}
 
+		mQueuedWindowsStart += i;
+	}
 
-		/*
-		if (mDQ0 != NULL)
-		{
-			mDQ0->AdvanceToAbsPosition(mCurrentSample);
-			mdq0_result.AddBit(mDQ0->GetBitState());
-		}
-		*/
-		mArrowLocations.push_back(mCurrentSample);
+	// decoded windows are never read again, so the index only has to hold the next batch
+	mEdgeIndex.Truncate(0);
+	mQueuedWindowsStart = 0;
+	mQueuedWindowsEnd = 0;
+}
 
+void QSPIAnalyzer::DecodeQueuedWindowsTask(void* analyzer, U32 worker)
+{
+	QSPIAnalyzer* self = static_cast<QSPIAnalyzer*>(analyzer);
+	self->DecodeQueuedWindowsWorker(&self->mWindowDecoders[worker]);
+}
 
-		//this isn't the very last bit, etc, so proceed as normal
-		if (WouldAdvancingTheClockToggleEnable() == true)
+void QSPIAnalyzer::DecodeQueuedWindowsWorker(QSPIWindowDecoder* decoder)
+{
+	const U32 window_count = U32(mQueuedWindowsEnd - mQueuedWindowsStart);
+
+	for (U32 i = mNextQueuedWindow++; i < window_count; i = mNextQueuedWindow++)
+	{
+		const QSPIEdgeIndex::Window& window = mEdgeIndex.GetWindow(mQueuedWindowsStart + i);
+		if (window.mClockStartState != mSettings->mClockInactiveState)
 		{
-			AdvanceToActiveEnableEdgeWithCorrectClockPolarity();  //ok, we pretty much need to reset everything and return.
-			return {-1,-1,0 }; // return values for error state
+			mQueuedSfdpBytes[i].clear();
+			mQueuedClocks[i].mMin = mQueuedClocks[i].mMedian = mQueuedClocks[i].mMax = mQueuedClocks[i].mGlitches = 0;
+			continue; // reported as an error frame when the results are added
 		}
 
-		mClock->AdvanceToNextEdge(); // advance to falling edge
+		decoder->DecodeWindow(mEdgeIndex, window);
+		mQueuedFrames[i].swap(decoder->GetFrames());
+		mQueuedMarkers[i].swap(decoder->GetMarkers());
+		mQueuedSfdpBytes[i].swap(decoder->GetSfdpBytes());
+		mQueuedClocks[i] = decoder->GetClockSummary();
 	}
+}
 
-	return_value.start = first_sample;
-	return_value.end = mClock->GetSampleNumber();
-	return_value.data = command_word;
-
-	return return_value;
+void QSPIAnalyzer::SaveSfdpByte(U32 address, U8 data)
+{
+	mSfdp.AddByte(address, data);
+}
 
+void QSPIAnalyzer::FinishSfdpRead()
+{
+	mSfdp.Configure(mCommands, mSettings->mModeState); // takes effect from the next transaction
 }
 
-void QSPIAnalyzer::SaveResults(QSPIAnalyzer::ParseResult return_value, QSPIFrameType frame_type) {
-	//save the resuls:
-	//U32 count = mArrowLocations.size();
-	//for (U32 i = 0; i<count; i++)
-	//	mResults->AddMarker(mArrowLocations[i], mArrowMarker, mSettings->mClockChannel);
+void QSPIAnalyzer::SaveResults(QSPIAnalyzer::ParseResult return_value, QSPIFrameType frame_type, U64 data2, U8 flags) {
+	//save the resuls (the sample markers were added by the Get* routines):
     if(return_value.start > 0 && return_value.end > 0)
     {
         Frame result_frame;
         result_frame.mStartingSampleInclusive = return_value.start;
         result_frame.mEndingSampleInclusive = return_value.end;
         result_frame.mData1 = return_value.data;
+        result_frame.mData2 = data2;
         result_frame.mType = frame_type;
-        result_frame.mFlags = 0;
-        mResults->AddFrame(result_frame);
+        result_frame.mFlags = flags;
+        if (QSPIClockStats::IsUndersampled(mClockStats.TakeShortestPeriod()) == true)
+            result_frame.mFlags |= UNDERSAMPLED_FLAG | DISPLAY_AS_WARNING_FLAG;
+        mResults->AddTransactionFrame(result_frame);
 
-        mResults->CommitResults();
+        mFramesSinceCommit++;
+        CommitResultsIfDue(return_value.end);
     }
 
 }
 
+void QSPIAnalyzer::SavePackedData(QSPIAnalyzer::ParseResult data, int DataLineMask)
+{
+	if (mPendingDataBytes == 0)
+	{
+		mPendingData = data;
+		mPendingDataLines = DataLineMask;
+	}
+	else
+	{
+		mPendingData.end = data.end;
+		mPendingData.data = (mPendingData.data << 8) | data.data;
+	}
+
+	mPendingDataBytes++;
+	if (mPendingDataBytes >= mSettings->mDataBytesPerFrame)
+		FlushPackedData();
+}
+
+void QSPIAnalyzer::FlushPackedData()
+{
+	if (mPendingDataBytes == 0)
+		return;
+
+	SaveResults(mPendingData, FrameTypeData, mPendingDataBytes | (U64(mPendingDataLines) << 8), PACKED_DATA_FLAG);
+	mPendingDataBytes = 0;
+}
+
+void QSPIAnalyzer::CommitResultsIfDue(U64 sample)
+{
+	// Committing and reporting progress are SDK round trips, so they are batched by frame count
+	// and by capture distance. Before the decoder blocks waiting for more capture data, everything
+	// decoded so far is handed over (AdvanceEnableToNextEdge, MoveClockToNextEdge), which keeps
+	// the display latency bounded.
+	if ((mFramesSinceCommit >= mSettings->mCommitFrameInterval) ||
+		(sample >= mLastCommitSample + mSettings->mCommitSampleInterval))
+	{
+		CommitResultsAndReportProgress(sample);
+	}
+}
+
+void QSPIAnalyzer::CommitResultsAndReportProgress(U64 sample)
+{
+	mResults->CommitResults();
+	ReportProgress(sample);
+
+	mFramesSinceCommit = 0;
+	mLastCommitSample = sample;
+}
+
 bool QSPIAnalyzer::NeedsRerun()
 {
 	return false;
@@ -629,7 +714,8 @@ U32 QSPIAnalyzer::GenerateSimulationData( U64 minimum_sample_index, U32 device_s
 
 U32 QSPIAnalyzer::GetMinimumSampleRateHz()
 {
-	return 10000; //we don't have any idea, depends on the SPI rate, etc.; return the lowest rate.
+	// without an expected SCLK we have no idea, so return the lowest rate
+	return std::max<U32>(10000, QSPIClockStats::GetMinimumSampleRate(mSettings->mExpectedClock));
 }
 
 const char* QSPIAnalyzer::GetAnalyzerName() const
@@ -4,6 +4,10 @@
 #include <Analyzer.h>
 #include "QSPIAnalyzerResults.h"
 #include "QSPISimulationDataGenerator.h"
+#include "QSPIEdgeIndex.h"
+#include "QSPIWindowDecoder.h"
+#include "QSPIWorkerPool.h"
+#include <atomic>
 
 class QSPIAnalyzerSettings;
 class ANALYZER_EXPORT QSPIAnalyzer : public Analyzer2
@@ -20,8 +24,10 @@ public:
 	virtual const char* GetAnalyzerName() const;
 	virtual bool NeedsRerun();
 
+#ifdef _MSC_VER
 #pragma warning( push )
 #pragma warning( disable : 4251 ) //warning C4251: 'SerialAnalyzer::<...>' : class <...> needs to have dll-interface to be used by clients of class
+#endif
 
 protected: //vars
 	std::auto_ptr< QSPIAnalyzerSettings > mSettings;
@@ -29,39 +35,91 @@ protected: //vars
 	bool mSimulationInitilized;
 	QSPISimulationDataGenerator mSimulationDataGenerator;
 
-	AnalyzerChannelData* mDQ0;
-	AnalyzerChannelData* mDQ1;
-	AnalyzerChannelData* mDQ2;
-	AnalyzerChannelData* mDQ3;
+	AnalyzerChannelData* mDQ[8]; // indexed by line number, NULL when the line is not connected
 	AnalyzerChannelData* mClock;
 	AnalyzerChannelData* mEnable;
 
 	U64 mCurrentSample;
+	U64 mWindowStart; // sample where enable went active
+	U64 mWindowEnd; // sample where enable goes inactive again, the end of the capture when there is no enable
+	bool mWindowOpen; // that enable edge was not captured when the window started, mWindowEnd is ~0 until it is found
+	bool mLastCapturedWindow; // no enable edge after mWindowEnd yet, so the clock may have none either
 	AnalyzerResults::MarkerType mArrowMarker;
-	std::vector<U64> mArrowLocations;
+	std::vector<U64> mArrowLocations; // sample points of the current field, sized in Setup and only filled when mRecordArrows
+	bool mRecordArrows;
 
-	struct ParseResult {
-		S64 start;
-		S64 end;
-		U64 data;
-	};
+	typedef QSPIParseResult ParseResult;
 
+	ParseResult mPendingData; // data bytes collected for the next packed data frame
+	U32 mPendingDataBytes;
+	int mPendingDataLines;
+
+	U64 mFramesSinceCommit;
+	U64 mLastCommitSample;
+
+	QSPIEdgeIndex mEdgeIndex; // the queued windows only, emptied once they are decoded
+	bool mUseEdgeIndex;
+	std::vector<QSPIWindowDecoder> mWindowDecoders; // one per decode thread
+	QSPIWorkerPool mWorkers; // runs DecodeQueuedWindowsTask, worker n on mWindowDecoders[n]
+	U64 mQueuedWindowsStart; // indexed windows waiting to be decoded: [start, end) of mEdgeIndex
+	U64 mQueuedWindowsEnd;
+	U32 mMaxQueuedWindows;
+	std::vector< std::vector<Frame> > mQueuedFrames;
+	std::vector< std::vector<QSPIWindowDecoder::Marker> > mQueuedMarkers;
+	std::atomic<U32> mNextQueuedWindow;
+
+	QSPIFrameParser<QSPIAnalyzer>::Parser mFrameParser; // streaming instance for the configured mode and address size
+
+	QSPICommandSet mCommands; // the settings' commands, as changed by the SFDP reads decoded so far this run
+	QSPISfdp mSfdp;
+	std::vector< std::vector<QSPISfdp::Byte> > mQueuedSfdpBytes;
+	std::vector<QSPIClockStats::Summary> mQueuedClocks;
+
+	QSPIClockStats mClockStats; // clock periods of the streamed transaction, fed by AdvanceClockInWindow
+	U64 mGlitchSamples; // clock pulses shorter than this are glitches, 0 with the filter off
+
+#ifdef _MSC_VER
 #pragma warning( pop )
+#endif
 
 protected: //functions
+	template <class DECODER, U32 MODE> friend QSPIParseResult GetQSPIField(DECODER& decoder, int CommandLineMask, U32 num_bits, bool dtr);
+	template <class DECODER, U32 MODE> friend QSPIParseResult GetQSPIDataByte(DECODER& decoder, int DataLineMask, bool dtr);
+	template <class DECODER, U32 MODE, U32 ADDRESS_BYTES> friend void ParseQSPIFrame(DECODER& decoder);
+
 	void Setup();
 	void AdvanceToActiveEnableEdge();
 	bool IsInitialClockPolarityCorrect();
 	void AdvanceToActiveEnableEdgeWithCorrectClockPolarity();
-	bool WouldAdvancingTheClockToggleEnable();
-	bool IsParseResultError(QSPIAnalyzer::ParseResult result);
-	void GetFrame();
-	ParseResult GetCommand(U64 CommandLineMask);
-	void SaveResults(QSPIAnalyzer::ParseResult return_value, QSPIFrameType frame_type);
-
-	ParseResult GetAddress(U64 AddressLineMask);
-	ParseResult GetDummy();
-	ParseResult GetData(U64 DataLineMask);
+	bool AdvanceClockInWindow();
+	bool MoveClockToNextEdge();
+	bool MoveClockInOpenWindow();
+	void CloseOpenWindow();
+	bool SkipClockGlitches();
+	void AdvanceEnableToNextEdge();
+	void SelectDecoder();
+	void AbandonTransaction();
+	void FinishTransaction(U64 window_start, U64 window_end, U64 sample, const QSPIClockStats::Summary& clock);
+	void SaveResults(QSPIAnalyzer::ParseResult return_value, QSPIFrameType frame_type, U64 data2 = 0, U8 flags = 0);
+	void SavePackedData(QSPIAnalyzer::ParseResult data, int DataLineMask);
+	void FlushPackedData();
+	void CommitResultsIfDue(U64 sample);
+	void CommitResultsAndReportProgress(U64 sample);
+
+	template <U32 LINE_MASK, bool DTR> ParseResult GetWord(U32 num_bits);
+	template <U32 LINE_MASK> U64 GatherLines(U64 sample);
+	template <U32 LINE_MASK, bool DTR> ParseResult GetDataByte() { return GetWord<LINE_MASK, DTR>(8); }
+	ParseResult GetDummy(U32 cycles);
+	ParseResult AbandonField(U32 bit_count, U64 first_sample, U64 last_sample);
+	void AddArrowMarkers(U32 bit_count, U64 first_sample, U64 last_sample, bool complete);
+	void SaveSfdpByte(U32 address, U8 data);
+	void FinishSfdpRead();
+
+	void DecodeIndexedWindows();
+	void StreamOpenWindow();
+	void DecodeQueuedWindows();
+	static void DecodeQueuedWindowsTask(void* analyzer, U32 worker);
+	void DecodeQueuedWindowsWorker(QSPIWindowDecoder* decoder);
 
 
 };
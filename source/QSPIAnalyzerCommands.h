@@ -1,15 +1,49 @@
+#ifndef QSPI_ANALYZER_COMMANDS
+#define QSPI_ANALYZER_COMMANDS
+
 #include <LogicPublicTypes.h>
+#include <string>
+#include <vector>
 
 struct CommandAttr {
 	bool AcceptsAddr;
 	bool UsesDummyCycles;
 	bool HasData;
 	bool isWrite;
-	int AddressLineMask;
-	int DataLineMask;
-	char CommandName[128];
+	U8 AddressLineMask;
+	U8 DataLineMask;
+	bool AddressDtr; // address and data sampled on both clock edges
+	bool DataDtr;
+	U8 AddressBytes; // 0: the Address Size setting
+	U8 DummyCycles; // 0: the Dummy Cycles setting
+	bool RegisterAddress; // the address selects a register or a side array (SFDP, ids, OTP, locks), not the flash array
+	bool Valid;
+};
+
+// The commands of one device profile. Every 8 bit opcode has its own slot, so the table is a
+// collision-free hash of the opcode and a lookup is a single load. The names are kept in a
+// separate pool, so the per-transaction lookups only touch the small CommandAttr entries.
+class QSPICommandSet
+{
+public:
+	QSPICommandSet();
+
+	void Clear();
+	void AddCommand(U8 opcode, const CommandAttr& attr, const char* name); // replaces an earlier entry
+	void SetAttr(U8 opcode, const CommandAttr& attr); // keeps the name of a listed opcode
+
+	const CommandAttr& GetAttr(U64 id) const { return mAttr[(id <= 0xFF) ? id : 0x100]; } // unknown opcodes are not Valid
+	bool IsValid(U64 id) const { return GetAttr(id).Valid; }
+	const char* GetName(U64 id) const;
+
+	U64 GetCount() const;
+	U64 GetCommand(U64 index) const; // the listed opcodes in ascending order
+
+protected:
+	CommandAttr mAttr[0x101];
+	U32 mNameOffset[0x101];
+	std::string mNames;
+	std::vector<U8> mOpcodes;
 };
 
-const CommandAttr& GetQSPICommandAttr(U64 id);
-bool IsCommandValid(U64 id);
-U64 GetQSPICommand(U64 index);
+#endif //QSPI_ANALYZER_COMMANDS
@@ -3,193 +3,527 @@
 #include "QSPIAnalyzer.h"
 #include "QSPIAnalyzerSettings.h"
 #include "QSPIAnalyzerCommands.h"
-#include <iostream>
-#include <sstream>
+#include "QSPIExportWriter.h"
+#include "QSPIColumnarExport.h"
+#include "QSPITransactionExport.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static const U16 NO_TRANSACTION_COMMAND = 0xFFFF;
 
 QSPIAnalyzerResults::QSPIAnalyzerResults( QSPIAnalyzer* analyzer, QSPIAnalyzerSettings* settings )
 :	AnalyzerResults(),
 	mSettings( settings ),
-	mAnalyzer( analyzer )
+	mAnalyzer( analyzer ),
+	mAddressStats( settings->mHeatmapBucketSize )
 {
+	ResetPendingTransaction();
 }
 
-QSPIAnalyzerResults::~QSPIAnalyzerResults()
+void QSPIAnalyzerResults::FindTransactions( U64 address, U64 length, std::vector<U64>& transaction_ids )
+{
+	std::lock_guard<std::mutex> lock( mTransactionsMutex );
+	mAddressIndex.FindTransactions( address, address + length, transaction_ids );
+}
+
+void QSPIAnalyzerResults::SetupBusMetrics( U32 sample_rate )
+{
+	std::lock_guard<std::mutex> lock( mTransactionsMutex );
+	mBusMetrics.Setup( sample_rate, U64( sample_rate ) * mSettings->mMetricsInterval / 1000000 );
+}
+
+void QSPIAnalyzerResults::GetFlashImage( U64 address, U32 count, U8* bytes )
+{
+	std::lock_guard<std::mutex> lock( mTransactionsMutex );
+	mFlashImage.GetBytes( address, count, bytes );
+}
+
+U64 QSPIAnalyzerResults::GetFlashImageEnd()
 {
+	std::lock_guard<std::mutex> lock( mTransactionsMutex );
+	return mFlashImage.GetEnd();
 }
 
-void QSPIAnalyzerResults::GenerateBubbleText( U64 frame_index, Channel& channel, DisplayBase display_base )
+void QSPIAnalyzerResults::ResetPendingTransaction()
 {
+	mPendingTransaction.mAddress = 0;
+	mPendingTransaction.mByteCount = 0;
+	mPendingTransaction.mCommand = NO_TRANSACTION_COMMAND;
+	mPendingTransaction.mAddressBits = 0;
+	mPendingTransaction.mFlags = 0;
+	mPendingTransaction.mAccess = QSPIFlashImage::AccessNone;
+	mPendingTransaction.mClock.mMin = 0;
+	mPendingTransaction.mClock.mMedian = 0;
+	mPendingTransaction.mClock.mMax = 0;
+	mPendingTransaction.mClock.mGlitches = 0;
+}
 
+QSPIAnalyzerResults::~QSPIAnalyzerResults()
+{
+}
+
+void QSPIAnalyzerResults::GenerateBubbleText( U64 frame_index, Channel& /*channel*/, DisplayBase display_base )
+{
 	ClearResultStrings();
+
+	const QSPITextCache::Entry* entry = mTextCache.Find( frame_index, display_base, QSPITextCache::BubbleText );
+	if( entry == NULL )
+		entry = FormatBubbleText( frame_index, display_base );
+
+	for( U32 i = 0; i < entry->mStringCount; i++ )
+		AddResultString( entry->mStrings[ i ] );
+}
+
+const QSPITextCache::Entry* QSPIAnalyzerResults::FormatBubbleText( U64 frame_index, DisplayBase display_base )
+{
+	QSPITextCache::Entry* entry = mTextCache.Insert( frame_index, display_base, QSPITextCache::BubbleText );
 	Frame frame = GetFrame( frame_index );
+	char number_str[ QSPITextCache::MAX_STRING_LENGTH ];
 
-	switch (frame.mType)
+	// shortest first, the display picks the longest that fits
+	switch( frame.mType )
 	{
 	case FrameTypeCommand:
-		{
-		char number_str[128];
-		AnalyzerHelpers::GetNumberString(frame.mData1, display_base, 8, number_str, 128);
+		AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, sizeof( number_str ) );
+		entry->AddString( number_str );
+		entry->AddString( "Cmd: ", number_str );
+		entry->AddString( "Command: ", number_str, " ", mSettings->mCommands.GetName( frame.mData1 ) );
+		break;
+	case FrameTypeAddress:
+		AnalyzerHelpers::GetNumberString( frame.mData1, display_base, GetAddressBits( frame ), number_str, sizeof( number_str ) );
+		entry->AddString( number_str );
+		entry->AddString( "Addr: ", number_str );
+		entry->AddString( "Address: ", number_str );
+		break;
+	case FrameTypeDummy:
+		entry->AddString( "Dummy" );
+		entry->AddString( "Dummy Cycles" );
+		break;
+	case FrameTypeData:
+		GetDataString( frame, display_base, number_str, sizeof( number_str ) );
+		entry->AddString( number_str );
+		entry->AddString( "Data: ", number_str );
+		if( ( frame.mFlags & FLASH_MISMATCH_FLAG ) != 0 )
+			entry->AddString( "Data: ", number_str, " (differs from flash image)" );
+		break;
+	default:
+		break;
+	}
 
-		AddResultString(number_str);
+	if( ( frame.mFlags & UNDERSAMPLED_FLAG ) != 0 )
+		entry->AppendToLastString( " (clock undersampled)" );
 
-		std::stringstream ss;
-		ss << "Cmd: " << number_str;
-		AddResultString(ss.str().c_str());
-		ss.str("");
+	return entry;
+}
 
-		ss << "Command: " << number_str << " " << GetQSPICommandAttr(frame.mData1).CommandName;
-		AddResultString(ss.str().c_str());
-		}
-		break;
-	case FrameTypeAddress:
+void QSPIAnalyzerResults::GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id )
+{
+	switch( export_type_user_id )
 	{
-		char number_str[128];
-		AnalyzerHelpers::GetNumberString(frame.mData1, display_base, 8, number_str, 128);
+	case 1:
+		GenerateColumnarExportFile( file );
+		return;
+	case 2:
+		GenerateTransactionExportFile( file, display_base );
+		return;
+	case 3:
+		GenerateFlashImageExportFile( file );
+		return;
+	case 4:
+		GenerateStatisticsExportFile( file );
+		return;
+	case 5:
+		GenerateBusMetricsExportFile( file );
+		return;
+	default:
+		break;
+	}
 
-		AddResultString(number_str);
+	U64 num_frames = GetNumFrames();
+	QSPIExportWriter writer( file, mAnalyzer->GetTriggerSample(), mAnalyzer->GetSampleRate() );
 
-		std::stringstream ss;
-		ss << "Addr: " << number_str;
-		AddResultString(ss.str().c_str());
-		ss.str("");
+	writer.AddText( "Time [s],Value" );
+	writer.EndLine();
 
-		ss << "Address: " << number_str;
-		AddResultString(ss.str().c_str());
-	}
-	case FrameTypeDummy:
+	for( U64 i = 0; i < num_frames; i++ )
 	{
-		std::stringstream ss;
-		ss << "Dummy";
-		AddResultString(ss.str().c_str());
-		ss.str("");
+		Frame frame = GetFrame( i );
 
-		ss << "Dummy Cycles";
-		AddResultString(ss.str().c_str());
-	}
-	case FrameTypeData:
-	{
-		char number_str[128];
-		AnalyzerHelpers::GetNumberString(frame.mData1, display_base, 8, number_str, 128);
+		// packed data frames are written back out as one row per byte; the byte times are
+		// interpolated across the frame since only its first and last sample are stored
+		U32 byte_count = ( frame.mType == FrameTypeData ) ? GetDataByteCount( frame ) : 1;
+		U32 value_bits = ( frame.mType == FrameTypeAddress ) ? GetAddressBits( frame ) : 8;
+		U64 frame_samples = frame.mEndingSampleInclusive - frame.mStartingSampleInclusive + 1;
 
-		AddResultString(number_str);
+		for( U32 b = 0; b < byte_count; b++ )
+		{
+			U64 byte_sample = frame.mStartingSampleInclusive + frame_samples * b / byte_count;
+			U64 byte_value = ( byte_count > 1 ) ? GetDataByte( frame, b ) : frame.mData1;
 
-		std::stringstream ss;
-		ss << "Data: " << number_str;
-		AddResultString(ss.str().c_str());
-		ss.str("");
+			writer.AddTime( byte_sample );
+			writer.AddChar( ',' );
+			writer.AddNumber( byte_value, display_base, value_bits );
+			writer.EndLine();
+		}
 
-		ss << "Data: " << number_str;
-		AddResultString(ss.str().c_str());
+		// the progress report is an SDK round trip, so it is made once per block of frames
+		if( ( ( i & 0x3FF ) == 0 ) && ( UpdateExportProgressAndCheckForCancel( i, num_frames ) == true ) )
+			return;
 	}
-	break;
 
-	default:
-		break;
+	UpdateExportProgressAndCheckForCancel( num_frames, num_frames );
+}
+
+void QSPIAnalyzerResults::GenerateColumnarExportFile( const char* file )
+{
+	U64 num_frames = GetNumFrames();
+	QSPIColumnarExport columns( file, mAnalyzer->GetTriggerSample(), mAnalyzer->GetSampleRate(), num_frames );
+
+	for( U64 i = 0; i < num_frames; i++ )
+	{
+		columns.AddFrame( GetFrame( i ) );
+
+		if( ( ( i & 0x3FF ) == 0 ) && ( UpdateExportProgressAndCheckForCancel( i, num_frames ) == true ) )
+			return;
 	}
 
+	UpdateExportProgressAndCheckForCancel( num_frames, num_frames );
 }
 
-void QSPIAnalyzerResults::GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id )
+void QSPIAnalyzerResults::GenerateTransactionExportFile( const char* file, DisplayBase display_base )
 {
-	std::stringstream ss;
-
-	U64 trigger_sample = mAnalyzer->GetTriggerSample();
-	U32 sample_rate = mAnalyzer->GetSampleRate();
 	U64 num_frames = GetNumFrames();
+	QSPITransactionExport transactions( file, mAnalyzer->GetTriggerSample(), mAnalyzer->GetSampleRate(), mSettings->mCommands,
+		display_base, mSettings->mAddressSize );
+
+	for( U64 i = 0; i < num_frames; i++ )
+	{
+		transactions.AddFrame( GetFrame( i ) );
+
+		if( ( ( i & 0x3FF ) == 0 ) && ( UpdateExportProgressAndCheckForCancel( i, num_frames ) == true ) )
+			return;
+	}
 
-	void* f = AnalyzerHelpers::StartFile(file);
+	UpdateExportProgressAndCheckForCancel( num_frames, num_frames );
+}
 
-	ss << "Time [s],Value" << std::endl;
+void QSPIAnalyzerResults::GenerateFlashImageExportFile( const char* file )
+{
+	// from address 0 to the last page the traffic told anything about, unknown bytes as 0xFF
+	const U64 end = GetFlashImageEnd();
+	QSPIExportWriter writer( file, mAnalyzer->GetTriggerSample(), mAnalyzer->GetSampleRate(), true );
 
-	for( U32 i=0; i < num_frames; i++ )
+	std::vector<U8> bytes( 0x10000 );
+	for( U64 address = 0; address < end; address += bytes.size() )
 	{
-		Frame frame = GetFrame( i );
-		
-		char time_str[128];
-		AnalyzerHelpers::GetTimeString( frame.mStartingSampleInclusive, trigger_sample, sample_rate, time_str, 128 );
+		const U32 count = U32( std::min<U64>( bytes.size(), end - address ) );
+		GetFlashImage( address, count, &bytes[ 0 ] );
+		writer.AddBytes( &bytes[ 0 ], count );
 
-		char number_str[128];
-		AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, 128 );
+		if( UpdateExportProgressAndCheckForCancel( address, end ) == true )
+			return;
+	}
 
-		ss << time_str << "," << number_str << std::endl;
+	UpdateExportProgressAndCheckForCancel( end, end );
+}
 
-		AnalyzerHelpers::AppendToFile((U8*)ss.str().c_str(), ss.str().length(), f);
-		ss.str(std::string());
+void QSPIAnalyzerResults::GenerateStatisticsExportFile( const char* file )
+{
+	QSPIExportWriter writer( file, mAnalyzer->GetTriggerSample(), mAnalyzer->GetSampleRate() );
+	{
+		std::lock_guard<std::mutex> lock( mTransactionsMutex );
+		mAddressStats.WriteSummary( writer );
+	}
 
-		if( UpdateExportProgressAndCheckForCancel( i, num_frames ) == true )
-		{
-			AnalyzerHelpers::EndFile(f);
-			return;
-		}
+	UpdateExportProgressAndCheckForCancel( GetNumFrames(), GetNumFrames() );
+}
+
+void QSPIAnalyzerResults::GenerateBusMetricsExportFile( const char* file )
+{
+	QSPIExportWriter writer( file, mAnalyzer->GetTriggerSample(), mAnalyzer->GetSampleRate() );
+	{
+		std::lock_guard<std::mutex> lock( mTransactionsMutex );
+		mBusMetrics.WriteTable( writer );
 	}
 
-	UpdateExportProgressAndCheckForCancel(num_frames, num_frames);
-	AnalyzerHelpers::EndFile(f);
+	UpdateExportProgressAndCheckForCancel( GetNumFrames(), GetNumFrames() );
 }
 
 void QSPIAnalyzerResults::GenerateFrameTabularText( U64 frame_index, DisplayBase display_base )
 {
 	ClearTabularText();
+
+	const QSPITextCache::Entry* entry = mTextCache.Find( frame_index, display_base, QSPITextCache::TabularText );
+	if( entry == NULL )
+		entry = FormatTabularText( frame_index, display_base );
+
+	if( entry->mStringCount > 0 )
+		AddTabularText( entry->mStrings[ 0 ] );
+}
+
+const QSPITextCache::Entry* QSPIAnalyzerResults::FormatTabularText( U64 frame_index, DisplayBase display_base )
+{
+	QSPITextCache::Entry* entry = mTextCache.Insert( frame_index, display_base, QSPITextCache::TabularText );
 	Frame frame = GetFrame( frame_index );
-	
-	switch (frame.mType)
+	char number_str[ QSPITextCache::MAX_STRING_LENGTH ];
+
+	switch( frame.mType )
 	{
 	case FrameTypeCommand:
-	{
-		char number_str[128];
-		AnalyzerHelpers::GetNumberString(frame.mData1, display_base, 8, number_str, 128);
+		AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, sizeof( number_str ) );
+		entry->AddString( "Command: ", number_str, " ", mSettings->mCommands.GetName( frame.mData1 ) );
+		break;
+	case FrameTypeAddress:
+		AnalyzerHelpers::GetNumberString( frame.mData1, display_base, GetAddressBits( frame ), number_str, sizeof( number_str ) );
+		entry->AddString( "Address: ", number_str );
+		break;
+	case FrameTypeDummy:
+		entry->AddString( "Dummy Cycles" );
+		break;
+	case FrameTypeData:
+		GetDataString( frame, display_base, number_str, sizeof( number_str ) );
+		if( ( frame.mFlags & FLASH_MISMATCH_FLAG ) != 0 )
+			entry->AddString( "Data: ", number_str, " (differs from flash image)" );
+		else
+			entry->AddString( "Data: ", number_str );
+		break;
+	default:
+		break;
+	}
 
-		std::stringstream ss;
+	if( ( frame.mFlags & UNDERSAMPLED_FLAG ) != 0 )
+		entry->AppendToLastString( " (clock undersampled)" );
 
-		ss << "Command: " << number_str << " " << GetQSPICommandAttr(frame.mData1).CommandName;
-		AddTabularText(ss.str().c_str());
-		break;
+	return entry;
+}
+
+U32 QSPIAnalyzerResults::GetAddressBits( const Frame& frame ) const
+{
+	return 8 * ( ( frame.mData2 != 0 ) ? U32( frame.mData2 ) : mSettings->mAddressSize );
+}
+
+U32 QSPIAnalyzerResults::GetDataByteCount( const Frame& frame )
+{
+	if( ( frame.mFlags & PACKED_DATA_FLAG ) == 0 )
+		return 1;
+
+	return U32( frame.mData2 & 0xFF );
+}
+
+U8 QSPIAnalyzerResults::GetDataByte( const Frame& frame, U32 index )
+{
+	U32 byte_count = GetDataByteCount( frame );
+
+	return U8( frame.mData1 >> ( 8 * ( byte_count - 1 - index ) ) );
+}
+
+void QSPIAnalyzerResults::GetDataString( const Frame& frame, DisplayBase display_base, char* result_string, U32 result_string_max_length )
+{
+	U32 byte_count = GetDataByteCount( frame );
+	if( byte_count <= 1 )
+	{
+		AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, result_string, result_string_max_length );
+		return;
 	}
-	case FrameTypeAddress:
+
+	// the bytes of a packed frame, separated by spaces
+	U32 length = 0;
+	result_string[0] = '\0';
+	for( U32 i = 0; i < byte_count; i++ )
 	{
-		char number_str[128];
-		AnalyzerHelpers::GetNumberString(frame.mData1, display_base, 8, number_str, 128);
+		char number_str[32];
+		AnalyzerHelpers::GetNumberString( GetDataByte( frame, i ), display_base, 8, number_str, sizeof( number_str ) );
 
-		std::stringstream ss;
+		U32 number_length = U32( strlen( number_str ) );
+		if( length + number_length + 2 > result_string_max_length )
+			break;
 
-		ss << "Address: " << number_str;
-		AddTabularText(ss.str().c_str());
-		break;
+		if( i > 0 )
+			result_string[length++] = ' ';
+		memcpy( result_string + length, number_str, number_length + 1 );
+		length += number_length;
 	}
-	case FrameTypeDummy:
+}
+
+void QSPIAnalyzerResults::GeneratePacketTabularText( U64 packet_id, DisplayBase display_base )
+{
+	ClearTabularText();
+	AddTransactionTabularText( packet_id, display_base );
+}
+
+void QSPIAnalyzerResults::GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base )
+{
+	ClearTabularText();
+	AddTransactionTabularText( transaction_id, display_base );
+}
+
+void QSPIAnalyzerResults::AddTransactionTabularText( U64 packet_id, DisplayBase display_base )
+{
+	TransactionSummary transaction;
 	{
-		std::stringstream ss;
+		std::lock_guard<std::mutex> lock( mTransactionsMutex );
+		if( packet_id >= mTransactions.size() )
+			return;
+		transaction = mTransactions[ packet_id ];
+	}
 
-		ss << "Dummy Cycles";
-		AddTabularText(ss.str().c_str());
-		break;
+	if( ( transaction.mFlags & DISPLAY_AS_ERROR_FLAG ) != 0 )
+	{
+		AddTabularText( "Clock polarity error" );
+		return;
 	}
-	case FrameTypeData:
+	if( transaction.mCommand == NO_TRANSACTION_COMMAND )
+		return;
+
+	char command_str[ QSPITextCache::MAX_STRING_LENGTH ];
+	char address_str[ QSPITextCache::MAX_STRING_LENGTH ] = "";
+	char length_str[ 32 ] = "";
+	AnalyzerHelpers::GetNumberString( transaction.mCommand, display_base, 8, command_str, sizeof( command_str ) );
+	if( transaction.mAddressBits != 0 )
 	{
-		char number_str[128];
-		AnalyzerHelpers::GetNumberString(frame.mData1, display_base, 8, number_str, 128);
+		strcpy( address_str, ", Address: " );
+		AnalyzerHelpers::GetNumberString( transaction.mAddress, display_base, transaction.mAddressBits,
+			address_str + strlen( address_str ), U32( sizeof( address_str ) - strlen( address_str ) ) );
+	}
+	if( transaction.mByteCount != 0 )
+		snprintf( length_str, sizeof( length_str ), ", %u byte%s", transaction.mByteCount, ( transaction.mByteCount == 1 ) ? "" : "s" );
+
+	// the clock as a frequency: the median, then the range from the longest period to the shortest;
+	// then the warnings
+	char clock_str[ 256 ] = "";
+	U32 clock_length = 0;
+	const double sample_rate = double( mAnalyzer->GetSampleRate() );
+	if( ( transaction.mClock.mMedian != 0 ) && ( sample_rate > 0.0 ) )
+		clock_length = snprintf( clock_str, sizeof( clock_str ), ", SCLK %.3g MHz (%.3g-%.3g MHz)", sample_rate / transaction.mClock.mMedian / 1e6,
+			sample_rate / transaction.mClock.mMax / 1e6, sample_rate / transaction.mClock.mMin / 1e6 );
+	if( transaction.mClock.mGlitches != 0 )
+		clock_length += snprintf( clock_str + clock_length, sizeof( clock_str ) - clock_length, ", %u clock glitch%s filtered",
+			transaction.mClock.mGlitches, ( transaction.mClock.mGlitches == 1 ) ? "" : "es" );
+	if( ( transaction.mFlags & UNDERSAMPLED_FLAG ) != 0 )
+		clock_length += snprintf( clock_str + clock_length, sizeof( clock_str ) - clock_length, ", clock undersampled" );
+	if( ( transaction.mFlags & FLASH_MISMATCH_FLAG ) != 0 )
+		snprintf( clock_str + clock_length, sizeof( clock_str ) - clock_length, ", differs from flash image" );
+
+	AddTabularText( command_str, " ", mSettings->mCommands.GetName( transaction.mCommand ), address_str, length_str, clock_str );
+}
 
-		std::stringstream ss;
+U64 QSPIAnalyzerResults::AddTransactionFrame( const Frame& frame )
+{
+	TransactionSummary& transaction = mPendingTransaction;
+	if( ( frame.mFlags & UNDERSAMPLED_FLAG ) != 0 )
+		transaction.mFlags |= UNDERSAMPLED_FLAG | DISPLAY_AS_WARNING_FLAG;
 
-		ss << "Data: " << number_str;
-		AddTabularText(ss.str().c_str());
-		break;
+	if( ( frame.mFlags & DISPLAY_AS_ERROR_FLAG ) != 0 )
+	{
+		transaction.mFlags |= DISPLAY_AS_ERROR_FLAG;
+	}
+	else if( ( frame.mType == FrameTypeCommand ) && ( transaction.mCommand == NO_TRANSACTION_COMMAND ) )
+	{
+		transaction.mCommand = U16( frame.mData1 & 0xFF );
+		transaction.mAccess = U8( QSPIFlashImage::GetAccess( U8( frame.mData1 ), mSettings->mCommands.GetAttr( frame.mData1 & 0xFF ) ) );
 	}
+	else if( ( frame.mType == FrameTypeAddress ) && ( transaction.mAddressBits == 0 ) )
+	{
+		transaction.mAddress = frame.mData1;
+		transaction.mAddressBits = U8( GetAddressBits( frame ) );
+	}
+	else if( frame.mType == FrameTypeData )
+	{
+		const U32 byte_count = GetDataByteCount( frame );
+		bool matches = true;
+		{
+			std::lock_guard<std::mutex> lock( mTransactionsMutex );
+			mBusMetrics.AddBytes( frame.mStartingSampleInclusive, byte_count, mSettings->mCommands.GetAttr( transaction.mCommand ).isWrite );
+			if( mSettings->mFlashModel != 0 )
+				matches = UpdateFlashImage( frame, byte_count );
+		}
+		transaction.mByteCount += byte_count;
 
-	default:
-		break;
+		if( matches == false )
+		{
+			Frame mismatch_frame = frame;
+			mismatch_frame.mFlags |= FLASH_MISMATCH_FLAG | DISPLAY_AS_WARNING_FLAG;
+			transaction.mFlags |= FLASH_MISMATCH_FLAG | DISPLAY_AS_WARNING_FLAG;
+			return AddFrame( mismatch_frame );
+		}
 	}
 
+	return AddFrame( frame );
 }
 
-void QSPIAnalyzerResults::GeneratePacketTabularText( U64 packet_id, DisplayBase display_base )
+bool QSPIAnalyzerResults::UpdateFlashImage( const Frame& frame, U32 byte_count )
 {
-	ClearResultStrings();
-	AddResultString( "not supported" );
+	const TransactionSummary& transaction = mPendingTransaction;
+	if( ( transaction.mAddressBits == 0 ) ||
+		( ( transaction.mAccess != QSPIFlashImage::AccessRead ) && ( transaction.mAccess != QSPIFlashImage::AccessProgram ) ) )
+		return true;
+
+	bool matches = true;
+	for( U32 b = 0; b < byte_count; b++ )
+	{
+		const U64 offset = transaction.mByteCount + b;
+		const U8 data = GetDataByte( frame, b );
+		if( transaction.mAccess == QSPIFlashImage::AccessProgram )
+		{
+			// a page program wraps around within its program page
+			const U64 page_mask = QSPIFlashImage::PROGRAM_PAGE_SIZE - 1;
+			mFlashImage.Program( ( transaction.mAddress & ~page_mask ) | ( ( transaction.mAddress + offset ) & page_mask ), data );
+		}
+		else if( mFlashImage.Read( transaction.mAddress + offset, data ) == false )
+		{
+			matches = false;
+		}
+	}
+
+	return matches;
 }
 
-void QSPIAnalyzerResults::GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base )
+void QSPIAnalyzerResults::CommitTransaction( U64 window_start, U64 window_end, const QSPIClockStats::Summary& clock )
 {
-	ClearResultStrings();
-	AddResultString( "not supported" );
-}
\ No newline at end of file
+	mPendingTransaction.mClock = clock;
+
+	if( window_end > window_start )
+	{
+		std::lock_guard<std::mutex> lock( mTransactionsMutex );
+		mBusMetrics.AddWindow( window_start, window_end );
+	}
+
+	const U64 packet_id = CommitPacketAndStartNewPacket();
+	if( packet_id != INVALID_RESULT_INDEX )
+	{
+		AddPacketToTransaction( packet_id, packet_id );
+
+		std::lock_guard<std::mutex> lock( mTransactionsMutex );
+		if( packet_id >= mTransactions.size() )
+			mTransactions.resize( packet_id + 1 );
+		mTransactions[ packet_id ] = mPendingTransaction;
+
+		const TransactionSummary& transaction = mPendingTransaction;
+		U64 start;
+		U64 end;
+		if( ( transaction.mCommand != NO_TRANSACTION_COMMAND ) &&
+			( QSPIAddressIndex::GetCommandRange( U8( transaction.mCommand ), mSettings->mCommands.GetAttr( transaction.mCommand ), transaction.mAddressBits != 0, transaction.mAddress,
+				transaction.mByteCount, start, end ) == true ) )
+		{
+			mAddressIndex.AddRange( start, end, packet_id );
+		}
+
+		if( ( transaction.mAccess == QSPIFlashImage::AccessErase ) &&
+			( QSPIFlashImage::GetEraseRange( U8( transaction.mCommand ), transaction.mAddressBits != 0, transaction.mAddress, start, end ) == true ) )
+		{
+			if( mSettings->mFlashModel != 0 )
+				mFlashImage.Erase( start, end );
+			mAddressStats.AddErase( start, end );
+		}
+		else if( ( transaction.mAddressBits != 0 ) && ( transaction.mByteCount != 0 ) )
+		{
+			if( transaction.mAccess == QSPIFlashImage::AccessRead )
+				mAddressStats.AddRead( transaction.mAddress, transaction.mAddress + transaction.mByteCount );
+			else if( transaction.mAccess == QSPIFlashImage::AccessProgram )
+				mAddressStats.AddProgram( transaction.mAddress, transaction.mAddress + transaction.mByteCount );
+		}
+	}
+
+	ResetPendingTransaction();
+}
@@ -2,9 +2,26 @@
 #define QSPI_ANALYZER_RESULTS
 
 #include <AnalyzerResults.h>
+#include "QSPITextCache.h"
+#include "QSPIAddressIndex.h"
+#include "QSPIFlashImage.h"
+#include "QSPIAddressStats.h"
+#include "QSPIBusMetrics.h"
+#include "QSPIClockStats.h"
+#include <mutex>
+#include <vector>
 
 enum QSPIFrameType { FrameTypeCommand, FrameTypeAddress, FrameTypeAlt, FrameTypeDummy, FrameTypeData };
 
+// Address frames hold the address byte count in mData2.
+// Data frame carrying several bytes: mData1 holds the bytes with the first one most significant,
+// mData2 holds the byte count in bits 0-7 and the data line mask in bits 8-15.
+#define PACKED_DATA_FLAG ( 1 << 0 )
+// Frames with a clock period under QSPIClockStats::MIN_SAMPLES_PER_CLOCK samples, and data frames
+// that differ from the flash image, also carry DISPLAY_AS_WARNING_FLAG.
+#define UNDERSAMPLED_FLAG ( 1 << 1 )
+#define FLASH_MISMATCH_FLAG ( 1 << 2 )
+
 class QSPIAnalyzer;
 class QSPIAnalyzerSettings;
 
@@ -21,11 +38,66 @@ public:
 	virtual void GeneratePacketTabularText( U64 packet_id, DisplayBase display_base );
 	virtual void GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base );
 
+	// Each chip-select window is one packet and one transaction with the same id. Frames added
+	// through AddTransactionFrame are summarized as they come, so the packet and transaction text
+	// needs no walk over the frames.
+	U64 AddTransactionFrame( const Frame& frame );
+	// the chip-select window, end <= start when there is none, and the clock periods measured in it
+	void CommitTransaction( U64 window_start, U64 window_end, const QSPIClockStats::Summary& clock );
+
+	// transactions that read, programmed or erased any of the bytes address to address + length - 1
+	void FindTransactions( U64 address, U64 length, std::vector<U64>& transaction_ids );
+
+	// The erases, programs and reads are also played into a model of the flash contents and the
+	// address statistics. Data frames of a read that differ from what the model holds get
+	// FLASH_MISMATCH_FLAG.
+	void GetFlashImage( U64 address, U32 count, U8* bytes ); // unknown bytes read as 0xFF
+	U64 GetFlashImageEnd();
+
+	// data bytes and chip-select windows over time, in buckets of the Throughput Interval setting
+	void SetupBusMetrics( U32 sample_rate );
+
+	static U32 GetDataByteCount( const Frame& frame );
+	static U8 GetDataByte( const Frame& frame, U32 index );
+
 protected: //functions
+	void GenerateColumnarExportFile( const char* file );
+	void GenerateTransactionExportFile( const char* file, DisplayBase display_base );
+	void GenerateFlashImageExportFile( const char* file );
+	void GenerateStatisticsExportFile( const char* file );
+	void GenerateBusMetricsExportFile( const char* file );
+	void GetDataString( const Frame& frame, DisplayBase display_base, char* result_string, U32 result_string_max_length );
+	U32 GetAddressBits( const Frame& frame ) const;
+	const QSPITextCache::Entry* FormatBubbleText( U64 frame_index, DisplayBase display_base );
+	const QSPITextCache::Entry* FormatTabularText( U64 frame_index, DisplayBase display_base );
+	void AddTransactionTabularText( U64 packet_id, DisplayBase display_base );
+	void ResetPendingTransaction();
+	bool UpdateFlashImage( const Frame& frame, U32 byte_count ); // with mTransactionsMutex held
+
+	struct TransactionSummary
+	{
+		U64 mAddress;
+		U32 mByteCount; // data bytes
+		U16 mCommand; // NO_TRANSACTION_COMMAND when the window has none
+		U8 mAddressBits; // 0 when the transaction has no address
+		U8 mFlags; // DISPLAY_AS_ERROR_FLAG for a window with the wrong clock polarity, otherwise
+				   // DISPLAY_AS_WARNING_FLAG with the frame flags that caused it
+		U8 mAccess; // QSPIFlashImage::Access
+		QSPIClockStats::Summary mClock;
+	};
 
 protected:  //vars
 	QSPIAnalyzerSettings* mSettings;
 	QSPIAnalyzer* mAnalyzer;
+	QSPITextCache mTextCache;
+
+	TransactionSummary mPendingTransaction;
+	std::vector<TransactionSummary> mTransactions; // by packet id, read from the UI thread while the analyzer adds to it
+	QSPIAddressIndex mAddressIndex;
+	QSPIFlashImage mFlashImage;
+	QSPIAddressStats mAddressStats;
+	QSPIBusMetrics mBusMetrics;
+	std::mutex mTransactionsMutex; // for all of the above
 };
 
 #endif //QSPI_ANALYZER_RESULTS
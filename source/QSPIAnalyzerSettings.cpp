@@ -10,10 +10,27 @@ QSPIAnalyzerSettings::QSPIAnalyzerSettings()
 	mDQ1Channel(UNDEFINED_CHANNEL),
 	mDQ2Channel(UNDEFINED_CHANNEL),
 	mDQ3Channel(UNDEFINED_CHANNEL),
+	mDQ4Channel(UNDEFINED_CHANNEL),
+	mDQ5Channel(UNDEFINED_CHANNEL),
+	mDQ6Channel(UNDEFINED_CHANNEL),
+	mDQ7Channel(UNDEFINED_CHANNEL),
 	mClockInactiveState(BIT_LOW),
 	mModeState(1),
 	mDummyCycles(8),
-	mAddressSize(3)
+	mAddressSize(3),
+	mDataBytesPerFrame(1),
+	mCommitFrameInterval(256),
+	mCommitSampleInterval(1000000),
+	mDecoder(DecoderStreaming),
+	mMarkerDetail(MarkersOff),
+	mDtrProtocol(0),
+	mDeviceProfile(ProfileGeneric),
+	mSfdpAutoSetup(1),
+	mHeatmapBucketSize(0x10000),
+	mMetricsInterval(1000),
+	mExpectedClock(0),
+	mClockGlitchFilter(0),
+	mFlashModel(1)
 
 {
 
@@ -44,6 +61,26 @@ QSPIAnalyzerSettings::QSPIAnalyzerSettings()
 	mDQ3ChannelInterface->SetChannel(mDQ3Channel);
 	mDQ3ChannelInterface->SetSelectionOfNoneIsAllowed(true);
 
+	mDQ4ChannelInterface.reset(new AnalyzerSettingInterfaceChannel());
+	mDQ4ChannelInterface->SetTitleAndTooltip("DQ4", "Data 4 (octal only)");
+	mDQ4ChannelInterface->SetChannel(mDQ4Channel);
+	mDQ4ChannelInterface->SetSelectionOfNoneIsAllowed(true);
+
+	mDQ5ChannelInterface.reset(new AnalyzerSettingInterfaceChannel());
+	mDQ5ChannelInterface->SetTitleAndTooltip("DQ5", "Data 5 (octal only)");
+	mDQ5ChannelInterface->SetChannel(mDQ5Channel);
+	mDQ5ChannelInterface->SetSelectionOfNoneIsAllowed(true);
+
+	mDQ6ChannelInterface.reset(new AnalyzerSettingInterfaceChannel());
+	mDQ6ChannelInterface->SetTitleAndTooltip("DQ6", "Data 6 (octal only)");
+	mDQ6ChannelInterface->SetChannel(mDQ6Channel);
+	mDQ6ChannelInterface->SetSelectionOfNoneIsAllowed(true);
+
+	mDQ7ChannelInterface.reset(new AnalyzerSettingInterfaceChannel());
+	mDQ7ChannelInterface->SetTitleAndTooltip("DQ7", "Data 7 (octal only)");
+	mDQ7ChannelInterface->SetChannel(mDQ7Channel);
+	mDQ7ChannelInterface->SetSelectionOfNoneIsAllowed(true);
+
 
 	mClockInactiveStateInterface.reset(new AnalyzerSettingInterfaceNumberList());
 	mClockInactiveStateInterface->SetTitleAndTooltip("Clock Polarity", "");
@@ -53,9 +90,10 @@ QSPIAnalyzerSettings::QSPIAnalyzerSettings()
 
 	mModeStateInterface.reset(new AnalyzerSettingInterfaceNumberList());
 	mModeStateInterface->SetTitleAndTooltip("SPI Mode", "");
-	mModeStateInterface->AddNumber(1, "Extended", "Extended mode (uses DQ0 for command and DQ[3:0] to data depending on command)");
+	mModeStateInterface->AddNumber(1, "Extended", "Extended mode (uses DQ0 for command and DQ[7:0] to data depending on command)");
 	mModeStateInterface->AddNumber(2, "Dual", "Dual mode (uses DQ[1:0])");
 	mModeStateInterface->AddNumber(3, "Quad", "Quad mode (uses DQ[3:0])");
+	mModeStateInterface->AddNumber(4, "Octal", "Octal mode (uses DQ[7:0])");
 	mModeStateInterface->SetNumber(mModeState);
 
 	mDummyCyclesInterface.reset(new AnalyzerSettingInterfaceNumberList());
@@ -76,6 +114,115 @@ QSPIAnalyzerSettings::QSPIAnalyzerSettings()
 	mAddressSizeInterface->AddNumber(4, "Four", "four byte addresses");
 	mAddressSizeInterface->SetNumber(mAddressSize);
 
+	mDataBytesPerFrameInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mDataBytesPerFrameInterface->SetTitleAndTooltip("Data Bytes per Frame", "Consecutive data bytes of a transaction packed into one result frame");
+	mDataBytesPerFrameInterface->AddNumber(1, "One", "one frame per data byte");
+	mDataBytesPerFrameInterface->AddNumber(2, "Two", "up to two data bytes per frame");
+	mDataBytesPerFrameInterface->AddNumber(4, "Four", "up to four data bytes per frame");
+	mDataBytesPerFrameInterface->AddNumber(8, "Eight", "up to eight data bytes per frame");
+	mDataBytesPerFrameInterface->SetNumber(mDataBytesPerFrame);
+
+	mCommitFrameIntervalInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mCommitFrameIntervalInterface->SetTitleAndTooltip("Result Update (frames)", "Decoded frames collected before the results are handed to the display");
+	mCommitFrameIntervalInterface->AddNumber(1, "Every frame", "update the display after every frame");
+	mCommitFrameIntervalInterface->AddNumber(16, "16 frames", "update the display every 16 frames");
+	mCommitFrameIntervalInterface->AddNumber(256, "256 frames", "update the display every 256 frames");
+	mCommitFrameIntervalInterface->AddNumber(4096, "4096 frames", "update the display every 4096 frames");
+	mCommitFrameIntervalInterface->SetNumber(mCommitFrameInterval);
+
+	mCommitSampleIntervalInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mCommitSampleIntervalInterface->SetTitleAndTooltip("Result Update (samples)", "Longest stretch of capture decoded before the results are handed to the display");
+	mCommitSampleIntervalInterface->AddNumber(100000, "100k samples", "update the display at least every 100k samples");
+	mCommitSampleIntervalInterface->AddNumber(1000000, "1M samples", "update the display at least every 1M samples");
+	mCommitSampleIntervalInterface->AddNumber(10000000, "10M samples", "update the display at least every 10M samples");
+	mCommitSampleIntervalInterface->SetNumber(mCommitSampleInterval);
+
+	mDecoderInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mDecoderInterface->SetTitleAndTooltip("Decoder", "");
+	mDecoderInterface->AddNumber(DecoderStreaming, "Streaming", "Decode bit by bit while walking the clock and data lines");
+	mDecoderInterface->AddNumber(DecoderEdgeIndex, "Two-pass (clock edge index)", "Index the clock edges of each chip-select window first, then decode from the index. Requires the Enable channel");
+	mDecoderInterface->AddNumber(DecoderParallel, "Two-pass, multi-threaded", "As two-pass, but batches of chip-select windows are decoded on all CPU cores. Meant for completed captures; results appear a batch at a time");
+	mDecoderInterface->SetNumber(mDecoder);
+
+	mMarkerDetailInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mMarkerDetailInterface->SetTitleAndTooltip("Sample Markers", "Markers on the clock line where the data lines are sampled");
+	mMarkerDetailInterface->AddNumber(MarkersOff, "Off", "no sample markers");
+	mMarkerDetailInterface->AddNumber(MarkersOnErrors, "Errors only", "mark the bits of fields cut short by chip select");
+	mMarkerDetailInterface->AddNumber(MarkersFirstLast, "First and last bit", "mark the first and last bit of every field, and fields cut short");
+	mMarkerDetailInterface->AddNumber(MarkersEveryBit, "Every bit", "mark every bit; slows down decoding of long captures");
+	mMarkerDetailInterface->SetNumber(mMarkerDetail);
+
+	mDtrProtocolInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mDtrProtocolInterface->SetTitleAndTooltip("DTR Protocol", "Devices in a DTR protocol mode clock every phase, the command included, on both edges");
+	mDtrProtocolInterface->AddNumber(0, "Off", "command sent on one edge; address and data on both edges for the DTR commands");
+	mDtrProtocolInterface->AddNumber(1, "On", "command, address and data all sampled on both clock edges");
+	mDtrProtocolInterface->SetNumber(mDtrProtocol);
+
+	mDeviceProfileInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mDeviceProfileInterface->SetTitleAndTooltip("Device Profile", "Command set of the flash device: opcodes, address size, dummy cycles and lanes");
+	mDeviceProfileInterface->AddNumber(ProfileGeneric, "Generic (Micron N25Q)", "the original command list; address size and dummy cycles from the settings above");
+	mDeviceProfileInterface->AddNumber(ProfileWinbond, "Winbond W25Q", "JEDEC basics, 4 byte address commands and the Winbond extras");
+	mDeviceProfileInterface->AddNumber(ProfileMacronix, "Macronix MX25L", "JEDEC basics, 4 byte address commands and the Macronix extras");
+	mDeviceProfileInterface->AddNumber(ProfileIssi, "ISSI IS25LP", "JEDEC basics, 4 byte address commands and the ISSI extras, DTR reads included");
+	mDeviceProfileInterface->AddNumber(ProfileGigaDevice, "GigaDevice GD25Q", "JEDEC basics, 4 byte address commands and the GigaDevice extras");
+	mDeviceProfileInterface->AddNumber(ProfileFile, "From file", "the commands listed in the profile file below");
+	mDeviceProfileInterface->SetNumber(mDeviceProfile);
+
+	mProfileFileInterface.reset(new AnalyzerSettingInterfaceText());
+	mProfileFileInterface->SetTitleAndTooltip("Profile File", "Command list used by the From file device profile, one command per line: opcode, name, address lines, address bytes, dummy cycles, data lines[, write][, dtr][, register]");
+	mProfileFileInterface->SetTextType(AnalyzerSettingInterfaceText::FilePath);
+	mProfileFileInterface->SetText(mProfileFile.c_str());
+
+	mSfdpAutoSetupInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mSfdpAutoSetupInterface->SetTitleAndTooltip("SFDP Auto Setup", "Take the address width and fast read dummy cycles from SFDP reads (0x5A) in the capture");
+	mSfdpAutoSetupInterface->AddNumber(0, "Off", "decode with the settings and device profile only");
+	mSfdpAutoSetupInterface->AddNumber(1, "On", "after an SFDP read of the basic parameter table, decode the rest of the capture with what it lists");
+	mSfdpAutoSetupInterface->SetNumber(mSfdpAutoSetup);
+
+	mHeatmapBucketSizeInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mHeatmapBucketSizeInterface->SetTitleAndTooltip("Heatmap Bucket", "Address range counted as one bucket in the access heatmap of the statistics export");
+	mHeatmapBucketSizeInterface->AddNumber(0x1000, "4 KB", "one bucket per subsector");
+	mHeatmapBucketSizeInterface->AddNumber(0x10000, "64 KB", "one bucket per sector");
+	mHeatmapBucketSizeInterface->AddNumber(0x100000, "1 MB", "one bucket per megabyte");
+	mHeatmapBucketSizeInterface->SetNumber(mHeatmapBucketSize);
+
+	mMetricsIntervalInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mMetricsIntervalInterface->SetTitleAndTooltip("Throughput Interval", "Length of one row of the bus throughput export");
+	mMetricsIntervalInterface->AddNumber(100, "100 us", "one row per 100 microseconds of capture");
+	mMetricsIntervalInterface->AddNumber(1000, "1 ms", "one row per millisecond of capture");
+	mMetricsIntervalInterface->AddNumber(10000, "10 ms", "one row per 10 milliseconds of capture");
+	mMetricsIntervalInterface->AddNumber(100000, "100 ms", "one row per 100 milliseconds of capture");
+	mMetricsIntervalInterface->AddNumber(1000000, "1 s", "one row per second of capture");
+	mMetricsIntervalInterface->SetNumber(mMetricsInterval);
+
+	mExpectedClockInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mExpectedClockInterface->SetTitleAndTooltip("Expected SCLK", "Fastest clock expected on the bus; the capture then needs at least 4 samples per clock period");
+	mExpectedClockInterface->AddNumber(0, "Unknown", "no minimum sample rate beyond the lowest one");
+	mExpectedClockInterface->AddNumber(1000000, "1 MHz", "needs a sample rate of 4 MS/s or more");
+	mExpectedClockInterface->AddNumber(5000000, "5 MHz", "needs a sample rate of 20 MS/s or more");
+	mExpectedClockInterface->AddNumber(10000000, "10 MHz", "needs a sample rate of 40 MS/s or more");
+	mExpectedClockInterface->AddNumber(25000000, "25 MHz", "needs a sample rate of 100 MS/s or more");
+	mExpectedClockInterface->AddNumber(50000000, "50 MHz", "needs a sample rate of 200 MS/s or more");
+	mExpectedClockInterface->AddNumber(100000000, "100 MHz", "needs a sample rate of 400 MS/s or more");
+	mExpectedClockInterface->AddNumber(133000000, "133 MHz", "needs a sample rate of 532 MS/s or more");
+	mExpectedClockInterface->SetNumber(mExpectedClock);
+
+	mClockGlitchFilterInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mClockGlitchFilterInterface->SetTitleAndTooltip("Clock Glitch Filter", "Clock pulses no longer than this are dropped before decoding, and marked when sample markers are on");
+	mClockGlitchFilterInterface->AddNumber(0, "Off", "every clock edge is a real edge");
+	mClockGlitchFilterInterface->AddNumber(5, "5 ns", "drop clock pulses of 5 ns or less");
+	mClockGlitchFilterInterface->AddNumber(10, "10 ns", "drop clock pulses of 10 ns or less");
+	mClockGlitchFilterInterface->AddNumber(20, "20 ns", "drop clock pulses of 20 ns or less");
+	mClockGlitchFilterInterface->AddNumber(50, "50 ns", "drop clock pulses of 50 ns or less");
+	mClockGlitchFilterInterface->AddNumber(100, "100 ns", "drop clock pulses of 100 ns or less");
+	mClockGlitchFilterInterface->SetNumber(mClockGlitchFilter);
+
+	mFlashModelInterface.reset(new AnalyzerSettingInterfaceNumberList());
+	mFlashModelInterface->SetTitleAndTooltip("Flash Image Model", "Keep a model of the flash contents from program, erase and read traffic, for the flash image export and the read mismatch warnings");
+	mFlashModelInterface->AddNumber(0, "Off", "no flash image; data frames are decoded without checking them against it");
+	mFlashModelInterface->AddNumber(1, "On", "reads are checked against the bytes programmed or read earlier in the capture");
+	mFlashModelInterface->SetNumber(mFlashModel);
+
 
 	AddInterface(mEnableChannelInterface.get());
 	AddInterface(mClockChannelInterface.get());
@@ -83,15 +230,46 @@ QSPIAnalyzerSettings::QSPIAnalyzerSettings()
 	AddInterface(mDQ1ChannelInterface.get());
 	AddInterface(mDQ2ChannelInterface.get());
 	AddInterface(mDQ3ChannelInterface.get());
+	AddInterface(mDQ4ChannelInterface.get());
+	AddInterface(mDQ5ChannelInterface.get());
+	AddInterface(mDQ6ChannelInterface.get());
+	AddInterface(mDQ7ChannelInterface.get());
 	AddInterface(mClockInactiveStateInterface.get());
 	AddInterface(mModeStateInterface.get());
 	AddInterface(mDummyCyclesInterface.get());
 	AddInterface(mAddressSizeInterface.get());
+	AddInterface(mDataBytesPerFrameInterface.get());
+	AddInterface(mCommitFrameIntervalInterface.get());
+	AddInterface(mCommitSampleIntervalInterface.get());
+	AddInterface(mDecoderInterface.get());
+	AddInterface(mMarkerDetailInterface.get());
+	AddInterface(mDtrProtocolInterface.get());
+	AddInterface(mDeviceProfileInterface.get());
+	AddInterface(mProfileFileInterface.get());
+	AddInterface(mSfdpAutoSetupInterface.get());
+	AddInterface(mHeatmapBucketSizeInterface.get());
+	AddInterface(mMetricsIntervalInterface.get());
+	AddInterface(mExpectedClockInterface.get());
+	AddInterface(mClockGlitchFilterInterface.get());
+	AddInterface(mFlashModelInterface.get());
 
 
 	AddExportOption( 0, "Export as text/csv file" );
 	AddExportExtension( 0, "text", "txt" );
 	AddExportExtension( 0, "csv", "csv" );
+	AddExportOption( 1, "Export as columnar binary file" );
+	AddExportExtension( 1, "binary", "qspicol" );
+	AddExportOption( 2, "Export transactions as text/csv file" );
+	AddExportExtension( 2, "text", "txt" );
+	AddExportExtension( 2, "csv", "csv" );
+	AddExportOption( 3, "Export reconstructed flash image" );
+	AddExportExtension( 3, "binary", "bin" );
+	AddExportOption( 4, "Export address statistics as text/csv file" );
+	AddExportExtension( 4, "text", "txt" );
+	AddExportExtension( 4, "csv", "csv" );
+	AddExportOption( 5, "Export bus throughput as text/csv file" );
+	AddExportExtension( 5, "text", "txt" );
+	AddExportExtension( 5, "csv", "csv" );
 
 	ClearChannels();
 	AddChannel(mEnableChannel, "CS", false);
@@ -100,6 +278,13 @@ QSPIAnalyzerSettings::QSPIAnalyzerSettings()
 	AddChannel(mDQ1Channel, "D1", false);
 	AddChannel(mDQ2Channel, "D2", false);
 	AddChannel(mDQ3Channel, "D3", false);
+	AddChannel(mDQ4Channel, "D4", false);
+	AddChannel(mDQ5Channel, "D5", false);
+	AddChannel(mDQ6Channel, "D6", false);
+	AddChannel(mDQ7Channel, "D7", false);
+
+	std::string error;
+	LoadDeviceProfile(mDeviceProfile, mProfileFile.c_str(), mCommands, error);
 }
 
 QSPIAnalyzerSettings::~QSPIAnalyzerSettings()
@@ -114,6 +299,10 @@ bool QSPIAnalyzerSettings::SetSettingsFromInterfaces()
 	Channel dq1 = mDQ1ChannelInterface->GetChannel();
 	Channel dq2 = mDQ2ChannelInterface->GetChannel();
 	Channel dq3 = mDQ3ChannelInterface->GetChannel();
+	Channel dq4 = mDQ4ChannelInterface->GetChannel();
+	Channel dq5 = mDQ5ChannelInterface->GetChannel();
+	Channel dq6 = mDQ6ChannelInterface->GetChannel();
+	Channel dq7 = mDQ7ChannelInterface->GetChannel();
 
 	std::vector<Channel> channels;
 	channels.push_back(enable);
@@ -122,6 +311,10 @@ bool QSPIAnalyzerSettings::SetSettingsFromInterfaces()
 	channels.push_back(dq1);
 	channels.push_back(dq2);
 	channels.push_back(dq3);
+	channels.push_back(dq4);
+	channels.push_back(dq5);
+	channels.push_back(dq6);
+	channels.push_back(dq7);
 
 	if (AnalyzerHelpers::DoChannelsOverlap(&channels[0], channels.size()) == true)
 	{
@@ -135,6 +328,17 @@ bool QSPIAnalyzerSettings::SetSettingsFromInterfaces()
 		return false;
 	}
 
+	// compile the profile before taking any setting, so a bad profile file leaves everything as it was
+	U32 device_profile = U32(mDeviceProfileInterface->GetNumber());
+	const char* profile_file = mProfileFileInterface->GetText();
+	QSPICommandSet commands;
+	std::string error;
+	if (LoadDeviceProfile(device_profile, profile_file, commands, error) == false)
+	{
+		SetErrorText(error.c_str());
+		return false;
+	}
+
 
 	mEnableChannel = mEnableChannelInterface->GetChannel();
 	mClockChannel = mClockChannelInterface->GetChannel();
@@ -142,11 +346,30 @@ bool QSPIAnalyzerSettings::SetSettingsFromInterfaces()
 	mDQ1Channel = mDQ1ChannelInterface->GetChannel();
 	mDQ2Channel = mDQ2ChannelInterface->GetChannel();
 	mDQ3Channel = mDQ3ChannelInterface->GetChannel();
+	mDQ4Channel = mDQ4ChannelInterface->GetChannel();
+	mDQ5Channel = mDQ5ChannelInterface->GetChannel();
+	mDQ6Channel = mDQ6ChannelInterface->GetChannel();
+	mDQ7Channel = mDQ7ChannelInterface->GetChannel();
 
 	mClockInactiveState = (BitState) U32(mClockInactiveStateInterface->GetNumber());
 	mModeState = U32(mModeStateInterface->GetNumber());
 	mDummyCycles = U32(mDummyCyclesInterface->GetNumber());
 	mAddressSize = U32(mAddressSizeInterface->GetNumber());
+	mDataBytesPerFrame = U32(mDataBytesPerFrameInterface->GetNumber());
+	mCommitFrameInterval = U32(mCommitFrameIntervalInterface->GetNumber());
+	mCommitSampleInterval = U32(mCommitSampleIntervalInterface->GetNumber());
+	mDecoder = U32(mDecoderInterface->GetNumber());
+	mMarkerDetail = U32(mMarkerDetailInterface->GetNumber());
+	mDtrProtocol = U32(mDtrProtocolInterface->GetNumber());
+	mDeviceProfile = device_profile;
+	mProfileFile = profile_file;
+	mCommands = commands;
+	mSfdpAutoSetup = U32(mSfdpAutoSetupInterface->GetNumber());
+	mHeatmapBucketSize = U32(mHeatmapBucketSizeInterface->GetNumber());
+	mMetricsInterval = U32(mMetricsIntervalInterface->GetNumber());
+	mExpectedClock = U32(mExpectedClockInterface->GetNumber());
+	mClockGlitchFilter = U32(mClockGlitchFilterInterface->GetNumber());
+	mFlashModel = U32(mFlashModelInterface->GetNumber());
 
 	ClearChannels();
 	AddChannel(mEnableChannel, "ENABLE", mEnableChannel != UNDEFINED_CHANNEL);
@@ -155,6 +378,10 @@ bool QSPIAnalyzerSettings::SetSettingsFromInterfaces()
 	AddChannel(mDQ1Channel, "DQ1", mDQ1Channel != UNDEFINED_CHANNEL);
 	AddChannel(mDQ2Channel, "DQ2", mDQ2Channel != UNDEFINED_CHANNEL);
 	AddChannel(mDQ3Channel, "DQ3", mDQ3Channel != UNDEFINED_CHANNEL);
+	AddChannel(mDQ4Channel, "DQ4", mDQ4Channel != UNDEFINED_CHANNEL);
+	AddChannel(mDQ5Channel, "DQ5", mDQ5Channel != UNDEFINED_CHANNEL);
+	AddChannel(mDQ6Channel, "DQ6", mDQ6Channel != UNDEFINED_CHANNEL);
+	AddChannel(mDQ7Channel, "DQ7", mDQ7Channel != UNDEFINED_CHANNEL);
 
 	return true;
 }
@@ -167,10 +394,28 @@ void QSPIAnalyzerSettings::UpdateInterfacesFromSettings()
 	mDQ1ChannelInterface->SetChannel(mDQ1Channel);
 	mDQ2ChannelInterface->SetChannel(mDQ2Channel);
 	mDQ3ChannelInterface->SetChannel(mDQ3Channel);
+	mDQ4ChannelInterface->SetChannel(mDQ4Channel);
+	mDQ5ChannelInterface->SetChannel(mDQ5Channel);
+	mDQ6ChannelInterface->SetChannel(mDQ6Channel);
+	mDQ7ChannelInterface->SetChannel(mDQ7Channel);
 	mClockInactiveStateInterface->SetNumber(mClockInactiveState);
 	mModeStateInterface->SetNumber(mModeState);
 	mDummyCyclesInterface->SetNumber(mDummyCycles);
 	mAddressSizeInterface->SetNumber(mAddressSize);
+	mDataBytesPerFrameInterface->SetNumber(mDataBytesPerFrame);
+	mCommitFrameIntervalInterface->SetNumber(mCommitFrameInterval);
+	mCommitSampleIntervalInterface->SetNumber(mCommitSampleInterval);
+	mDecoderInterface->SetNumber(mDecoder);
+	mMarkerDetailInterface->SetNumber(mMarkerDetail);
+	mDtrProtocolInterface->SetNumber(mDtrProtocol);
+	mDeviceProfileInterface->SetNumber(mDeviceProfile);
+	mProfileFileInterface->SetText(mProfileFile.c_str());
+	mSfdpAutoSetupInterface->SetNumber(mSfdpAutoSetup);
+	mHeatmapBucketSizeInterface->SetNumber(mHeatmapBucketSize);
+	mMetricsIntervalInterface->SetNumber(mMetricsInterval);
+	mExpectedClockInterface->SetNumber(mExpectedClock);
+	mClockGlitchFilterInterface->SetNumber(mClockGlitchFilter);
+	mFlashModelInterface->SetNumber(mFlashModel);
 }
 
 void QSPIAnalyzerSettings::LoadSettings( const char* settings )
@@ -185,10 +430,40 @@ void QSPIAnalyzerSettings::LoadSettings( const char* settings )
 	text_archive >> mDQ1Channel;
 	text_archive >> mDQ2Channel;
 	text_archive >> mDQ3Channel;
-	text_archive >> *(U32*)&mClockInactiveState;
+	U32 clock_inactive_state = mClockInactiveState;
+	text_archive >> clock_inactive_state;
+	mClockInactiveState = (BitState) clock_inactive_state;
 	text_archive >> *(U32*)&mModeState;
 	text_archive >> *(U32*)&mDummyCycles;
 	text_archive >> *(U32*)&mAddressSize;
+	text_archive >> *(U32*)&mDataBytesPerFrame;
+	text_archive >> *(U32*)&mCommitFrameInterval;
+	text_archive >> *(U32*)&mCommitSampleInterval;
+	text_archive >> *(U32*)&mDecoder;
+	text_archive >> *(U32*)&mMarkerDetail;
+	text_archive >> *(U32*)&mDtrProtocol;
+	text_archive >> mDQ4Channel;
+	text_archive >> mDQ5Channel;
+	text_archive >> mDQ6Channel;
+	text_archive >> mDQ7Channel;
+	text_archive >> *(U32*)&mDeviceProfile;
+	const char* profile_file;
+	if (text_archive >> &profile_file)
+		mProfileFile = profile_file;
+	text_archive >> *(U32*)&mSfdpAutoSetup;
+	text_archive >> *(U32*)&mHeatmapBucketSize;
+	text_archive >> *(U32*)&mMetricsInterval;
+	text_archive >> *(U32*)&mExpectedClock;
+	text_archive >> *(U32*)&mClockGlitchFilter;
+	text_archive >> *(U32*)&mFlashModel;
+
+	// a profile file that has gone missing since the settings were saved falls back to the generic commands
+	std::string error;
+	if (LoadDeviceProfile(mDeviceProfile, mProfileFile.c_str(), mCommands, error) == false)
+	{
+		mDeviceProfile = ProfileGeneric;
+		LoadDeviceProfile(mDeviceProfile, mProfileFile.c_str(), mCommands, error);
+	}
 
 	ClearChannels();
 	AddChannel(mEnableChannel, "ENABLE", mEnableChannel != UNDEFINED_CHANNEL);
@@ -197,6 +472,10 @@ void QSPIAnalyzerSettings::LoadSettings( const char* settings )
 	AddChannel(mDQ1Channel, "DQ1", mDQ1Channel != UNDEFINED_CHANNEL);
 	AddChannel(mDQ2Channel, "DQ2", mDQ2Channel != UNDEFINED_CHANNEL);
 	AddChannel(mDQ3Channel, "DQ3", mDQ3Channel != UNDEFINED_CHANNEL);
+	AddChannel(mDQ4Channel, "DQ4", mDQ4Channel != UNDEFINED_CHANNEL);
+	AddChannel(mDQ5Channel, "DQ5", mDQ5Channel != UNDEFINED_CHANNEL);
+	AddChannel(mDQ6Channel, "DQ6", mDQ6Channel != UNDEFINED_CHANNEL);
+	AddChannel(mDQ7Channel, "DQ7", mDQ7Channel != UNDEFINED_CHANNEL);
 
 	UpdateInterfacesFromSettings();
 }
@@ -215,6 +494,24 @@ const char* QSPIAnalyzerSettings::SaveSettings()
 	text_archive << mModeState;
 	text_archive << mDummyCycles;
 	text_archive << mAddressSize;
+	text_archive << mDataBytesPerFrame;
+	text_archive << mCommitFrameInterval;
+	text_archive << mCommitSampleInterval;
+	text_archive << mDecoder;
+	text_archive << mMarkerDetail;
+	text_archive << mDtrProtocol;
+	text_archive << mDQ4Channel;
+	text_archive << mDQ5Channel;
+	text_archive << mDQ6Channel;
+	text_archive << mDQ7Channel;
+	text_archive << mDeviceProfile;
+	text_archive << mProfileFile.c_str();
+	text_archive << mSfdpAutoSetup;
+	text_archive << mHeatmapBucketSize;
+	text_archive << mMetricsInterval;
+	text_archive << mExpectedClock;
+	text_archive << mClockGlitchFilter;
+	text_archive << mFlashModel;
 
 	return SetReturnString( text_archive.GetString() );
 }
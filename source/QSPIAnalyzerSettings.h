@@ -3,6 +3,12 @@
 
 #include <AnalyzerSettings.h>
 #include <AnalyzerTypes.h>
+#include <string>
+#include "QSPIDeviceProfiles.h"
+
+enum QSPIModeState { ModeStateExtended = 1, ModeStateDual = 2, ModeStateQuad = 3, ModeStateOctal = 4 };
+enum QSPIDecoder { DecoderStreaming = 0, DecoderEdgeIndex = 1, DecoderParallel = 2 };
+enum QSPIMarkerDetail { MarkersOff = 0, MarkersOnErrors = 1, MarkersFirstLast = 2, MarkersEveryBit = 3 };
 
 class QSPIAnalyzerSettings : public AnalyzerSettings
 {
@@ -22,10 +28,30 @@ public:
 	Channel mDQ1Channel;
 	Channel mDQ2Channel;
 	Channel mDQ3Channel;
+	Channel mDQ4Channel;
+	Channel mDQ5Channel;
+	Channel mDQ6Channel;
+	Channel mDQ7Channel;
 	BitState mClockInactiveState;
 	U32 mModeState;
 	U32 mDummyCycles;
 	U32 mAddressSize;
+	U32 mDataBytesPerFrame;
+	U32 mCommitFrameInterval;
+	U32 mCommitSampleInterval;
+	U32 mDecoder;
+	U32 mMarkerDetail;
+	U32 mDtrProtocol;
+	U32 mDeviceProfile;
+	std::string mProfileFile;
+	U32 mSfdpAutoSetup;
+	U32 mHeatmapBucketSize;
+	U32 mMetricsInterval; // microseconds
+	U32 mExpectedClock; // Hz, 0 when not known
+	U32 mClockGlitchFilter; // ns, 0 for off
+	U32 mFlashModel;
+
+	QSPICommandSet mCommands; // compiled from mDeviceProfile
 
 
 protected:
@@ -35,10 +61,28 @@ protected:
 	std::auto_ptr< AnalyzerSettingInterfaceChannel >	mDQ1ChannelInterface;
 	std::auto_ptr< AnalyzerSettingInterfaceChannel >	mDQ2ChannelInterface;
 	std::auto_ptr< AnalyzerSettingInterfaceChannel >	mDQ3ChannelInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceChannel >	mDQ4ChannelInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceChannel >	mDQ5ChannelInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceChannel >	mDQ6ChannelInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceChannel >	mDQ7ChannelInterface;
 	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mClockInactiveStateInterface;
 	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mModeStateInterface;
 	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mDummyCyclesInterface;
 	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mAddressSizeInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mDataBytesPerFrameInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mCommitFrameIntervalInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mCommitSampleIntervalInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mDecoderInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mMarkerDetailInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mDtrProtocolInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mDeviceProfileInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceText >	mProfileFileInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mSfdpAutoSetupInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mHeatmapBucketSizeInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mMetricsIntervalInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mExpectedClockInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mClockGlitchFilterInterface;
+	std::auto_ptr< AnalyzerSettingInterfaceNumberList >	mFlashModelInterface;
 
 };
 
@@ -0,0 +1,108 @@
+#include "QSPIBusMetrics.h"
+#include <algorithm>
+
+QSPIBusMetrics::QSPIBusMetrics()
+:	mSampleRate(0),
+	mBucketSamples(0),
+	mLastWindowEnd(0),
+	mHasLastWindow(false)
+{
+}
+
+void QSPIBusMetrics::Setup(U32 sample_rate, U64 bucket_samples)
+{
+	mBuckets.clear();
+	mSampleRate = sample_rate;
+	mBucketSamples = std::max<U64>(bucket_samples, 1);
+	mHasLastWindow = false;
+}
+
+void QSPIBusMetrics::AddBytes(U64 sample, U32 byte_count, bool is_write)
+{
+	if (mBucketSamples == 0)
+		return;
+
+	Bucket& bucket = GetBucket(sample / mBucketSamples);
+	if (is_write == true)
+		bucket.mWriteBytes += byte_count;
+	else
+		bucket.mReadBytes += byte_count;
+}
+
+void QSPIBusMetrics::AddWindow(U64 start, U64 end)
+{
+	if ((mBucketSamples == 0) || (end < start))
+		return;
+
+	Bucket& first = GetBucket(start / mBucketSamples);
+	first.mWindows++;
+	if ((mHasLastWindow == true) && (start > mLastWindowEnd))
+	{
+		const U64 gap = start - mLastWindowEnd;
+		first.mGaps++;
+		first.mGapSamples += gap;
+		first.mMaxGapSamples = std::max(first.mMaxGapSamples, gap);
+	}
+	mLastWindowEnd = end;
+	mHasLastWindow = true;
+
+	// the active time, split at the bucket boundaries
+	for (U64 index = start / mBucketSamples; index <= end / mBucketSamples; index++)
+	{
+		const U64 bucket_start = std::max(start, index * mBucketSamples);
+		const U64 bucket_end = std::min(end + 1, (index + 1) * mBucketSamples);
+		GetBucket(index).mActiveSamples += bucket_end - bucket_start;
+	}
+}
+
+void QSPIBusMetrics::WriteTable(QSPIExportWriter& writer) const
+{
+	writer.AddText("Time [s],Read bytes,Write bytes,CS active [%],Transactions/s,Mean idle gap [s],Max idle gap [s]");
+	writer.EndLine();
+
+	for (size_t i = 0; i < mBuckets.size(); i++)
+	{
+		const Bucket& bucket = mBuckets[i];
+
+		writer.AddTime(bucket.mIndex * mBucketSamples);
+		writer.AddChar(',');
+		writer.AddNumber(bucket.mReadBytes, Decimal, 32);
+		writer.AddChar(',');
+		writer.AddNumber(bucket.mWriteBytes, Decimal, 32);
+		writer.AddChar(',');
+		writer.AddFixedPoint(std::min<U64>(bucket.mActiveSamples, mBucketSamples) * 10000 / mBucketSamples, 2);
+		writer.AddChar(',');
+		writer.AddNumber(U64(bucket.mWindows) * mSampleRate / mBucketSamples, Decimal, 64);
+		writer.AddChar(',');
+		if (bucket.mGaps != 0)
+		{
+			writer.AddDuration(bucket.mGapSamples / bucket.mGaps);
+			writer.AddChar(',');
+			writer.AddDuration(bucket.mMaxGapSamples);
+		}
+		else
+		{
+			writer.AddChar(',');
+		}
+		writer.EndLine();
+	}
+}
+
+QSPIBusMetrics::Bucket& QSPIBusMetrics::GetBucket(U64 index)
+{
+	// the decoders report in time order, so nearly every lookup is the last bucket or a new one
+	if (mBuckets.empty() || (mBuckets.back().mIndex < index))
+	{
+		Bucket bucket = { index, 0, 0, 0, 0, 0, 0, 0 };
+		mBuckets.push_back(bucket);
+		return mBuckets.back();
+	}
+	if (mBuckets.back().mIndex == index)
+		return mBuckets.back();
+
+	Bucket key = { index, 0, 0, 0, 0, 0, 0, 0 };
+	std::vector<Bucket>::iterator bucket = std::lower_bound(mBuckets.begin(), mBuckets.end(), key);
+	if ((bucket == mBuckets.end()) || (bucket->mIndex != index))
+		bucket = mBuckets.insert(bucket, key);
+	return *bucket;
+}
@@ -0,0 +1,48 @@
+#ifndef QSPI_BUS_METRICS
+#define QSPI_BUS_METRICS
+
+#include <LogicPublicTypes.h>
+#include <vector>
+#include "QSPIExportWriter.h"
+
+// Bus throughput over time, in buckets of a fixed number of samples: data bytes read and
+// written, the share of the bucket with chip select active, transactions per second, and the
+// idle gaps between chip-select windows (counted in the bucket where the gap ends). Only the
+// buckets with some activity are stored, in time order.
+class QSPIBusMetrics
+{
+public:
+	QSPIBusMetrics();
+
+	void Setup(U32 sample_rate, U64 bucket_samples);
+
+	void AddBytes(U64 sample, U32 byte_count, bool is_write);
+	void AddWindow(U64 start, U64 end); // chip select active from start to end
+
+	// "Time [s],Read bytes,Write bytes,CS active [%],Transactions/s,Mean idle gap [s],Max idle gap [s]"
+	void WriteTable(QSPIExportWriter& writer) const;
+
+protected:
+	struct Bucket
+	{
+		U64 mIndex;
+		U64 mActiveSamples;
+		U64 mGapSamples; // sum of mGaps gaps
+		U64 mMaxGapSamples;
+		U32 mReadBytes;
+		U32 mWriteBytes;
+		U32 mWindows;
+		U32 mGaps;
+		bool operator<(const Bucket& other) const { return mIndex < other.mIndex; }
+	};
+
+	Bucket& GetBucket(U64 index);
+
+	std::vector<Bucket> mBuckets;
+	U32 mSampleRate;
+	U64 mBucketSamples; // 0 until Setup
+	U64 mLastWindowEnd;
+	bool mHasLastWindow;
+};
+
+#endif //QSPI_BUS_METRICS
@@ -0,0 +1,86 @@
+#include "QSPIClockStats.h"
+#include <algorithm>
+#include <cstring>
+
+QSPIClockStats::QSPIClockStats()
+{
+	memset(mBins, 0, sizeof(mBins));
+	mLowBin = BIN_COUNT;
+	mHighBin = 0;
+	Clear();
+}
+
+void QSPIClockStats::Clear()
+{
+	if (mLowBin <= mHighBin)
+		memset(&mBins[mLowBin], 0, (mHighBin - mLowBin + 1) * sizeof(mBins[0]));
+	mLowBin = BIN_COUNT;
+	mHighBin = 0;
+	mPeriodCount = 0;
+	mEdgeCount = 0;
+	mShortestPeriod = ~U64(0);
+	mMinPeriod = ~U64(0);
+	mMaxPeriod = 0;
+	mGlitches = 0;
+}
+
+void QSPIClockStats::AddEdges(const U64* edges, U32 count)
+{
+	for (U32 i = 0; i < count; i++)
+		AddEdge(edges[i]);
+}
+
+U64 QSPIClockStats::TakeShortestPeriod()
+{
+	const U64 shortest = mShortestPeriod;
+	mMinPeriod = std::min(mMinPeriod, shortest);
+	mShortestPeriod = ~U64(0);
+	return shortest;
+}
+
+void QSPIClockStats::GetSummary(Summary& summary)
+{
+	summary.mGlitches = mGlitches;
+	if (mPeriodCount == 0)
+	{
+		summary.mMin = 0;
+		summary.mMedian = 0;
+		summary.mMax = 0;
+		return;
+	}
+
+	// the bin of period number mPeriodCount / 2 in sorted order
+	const U64 min_period = std::min(mMinPeriod, mShortestPeriod);
+	U32 bin = mLowBin;
+	for (U64 below = mBins[bin]; below <= mPeriodCount / 2; below += mBins[bin])
+		bin++;
+
+	summary.mMin = U32(std::min<U64>(min_period, 0xFFFFFFFF));
+	summary.mMax = U32(std::min<U64>(mMaxPeriod, 0xFFFFFFFF));
+	summary.mMedian = std::min(std::max(GetBinPeriod(bin), summary.mMin), summary.mMax);
+}
+
+U32 QSPIClockStats::GetBin(U64 period)
+{
+	// the top 6 bits of the period pick the bin within its doubling
+	if (period > 0xFFFFFFFF)
+		period = 0xFFFFFFFF;
+	U32 shift = 0;
+	while ((period >> shift) >= EXACT_PERIODS)
+		shift++;
+	return shift * BINS_PER_DOUBLING + U32(period >> shift);
+}
+
+U32 QSPIClockStats::GetBinPeriod(U32 bin)
+{
+	if (bin < EXACT_PERIODS)
+		return bin;
+	const U32 shift = (bin - EXACT_PERIODS) / BINS_PER_DOUBLING + 1;
+	const U64 first = U64(bin - shift * BINS_PER_DOUBLING) << shift;
+	return U32(std::min<U64>(first + (U64(1) << shift) / 2, 0xFFFFFFFF));
+}
+
+U32 QSPIClockStats::GetMinimumSampleRate(U32 sclk_hz)
+{
+	return U32(std::min<U64>(U64(sclk_hz) * MIN_SAMPLES_PER_CLOCK, 0xFFFFFFFF));
+}
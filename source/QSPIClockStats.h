@@ -0,0 +1,83 @@
+#ifndef QSPI_CLOCK_STATS
+#define QSPI_CLOCK_STATS
+
+#include <LogicPublicTypes.h>
+
+// Clock periods of one transaction, in samples from each clock edge to the next edge in the same
+// direction, and the glitches the decoder dropped from the clock. Edges come in order, either one
+// at a time from the streaming decoder or as a run of a window's edge list. Besides the
+// distribution it keeps the shortest period since the last TakeShortestPeriod, so a decoder can
+// tell which frames were clocked too fast to sample safely.
+//
+// The median comes from a histogram of fixed size: one bin per period below 64 samples, and above
+// that 32 bins per doubling, so a long period's median is off by at most 1/64 of it.
+class QSPIClockStats
+{
+public:
+	enum
+	{
+		MIN_SAMPLES_PER_CLOCK = 4, // a sample rate of 4 x SCLK gives every clock level at least two samples
+		EXACT_PERIODS = 64, // periods with a bin of their own
+		BINS_PER_DOUBLING = 32,
+		BIN_COUNT = 26 * BINS_PER_DOUBLING + EXACT_PERIODS // up to a period of 0xFFFFFFFF
+	};
+
+	struct Summary
+	{
+		U32 mMin; // all 0 when the transaction had no whole clock period
+		U32 mMedian;
+		U32 mMax;
+		U32 mGlitches;
+	};
+
+	QSPIClockStats();
+
+	void Clear();
+
+	inline void AddEdge(U64 sample)
+	{
+		if (mEdgeCount >= 2)
+			AddPeriod(sample - mLastEdges[mEdgeCount & 1]);
+		mLastEdges[mEdgeCount & 1] = sample;
+		mEdgeCount++;
+	}
+	void AddEdges(const U64* edges, U32 count);
+	void AddGlitch() { mGlitches++; }
+
+	U64 TakeShortestPeriod(); // ~0 when no period ended since the last call
+	void GetSummary(Summary& summary);
+
+	static bool IsUndersampled(U64 shortest_period) { return shortest_period < MIN_SAMPLES_PER_CLOCK; }
+	static U32 GetMinimumSampleRate(U32 sclk_hz); // 0 when SCLK is not known
+
+protected:
+	inline void AddPeriod(U64 period)
+	{
+		if (period < mShortestPeriod)
+			mShortestPeriod = period;
+		if (period > mMaxPeriod)
+			mMaxPeriod = period;
+		const U32 bin = (period < EXACT_PERIODS) ? U32(period) : GetBin(period);
+		mBins[bin]++;
+		if (bin < mLowBin)
+			mLowBin = bin;
+		if (bin > mHighBin)
+			mHighBin = bin;
+		mPeriodCount++;
+	}
+	static U32 GetBin(U64 period);
+	static U32 GetBinPeriod(U32 bin); // the middle of the bin's periods
+
+	U32 mBins[BIN_COUNT]; // only mLowBin to mHighBin can be nonzero
+	U32 mLowBin;
+	U32 mHighBin;
+	U64 mPeriodCount;
+	U64 mLastEdges[2]; // by edge count parity
+	U64 mEdgeCount;
+	U64 mShortestPeriod;
+	U64 mMinPeriod;
+	U64 mMaxPeriod;
+	U32 mGlitches;
+};
+
+#endif //QSPI_CLOCK_STATS
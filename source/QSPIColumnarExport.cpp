@@ -0,0 +1,130 @@
+#include "QSPIColumnarExport.h"
+#include "QSPIAnalyzerResults.h"
+
+static const U32 COLUMN_WIDTHS[] = { 8, 8, 8, 4, 2, 1, 1, 1 };
+static const U32 NO_ADDRESS = 0xFFFFFFFF;
+static const U32 NO_COMMAND = 0xFFFF;
+
+enum QSPIColumn { ColumnStartSample, ColumnEndSample, ColumnData, ColumnAddress, ColumnCommand, ColumnType, ColumnDataCount, ColumnFlags };
+
+QSPIColumnarExport::QSPIColumnarExport( const char* file, U64 trigger_sample, U32 sample_rate, U64 row_count )
+:	mFile( file, std::ios::out | std::ios::binary | std::ios::trunc ),
+	mRowCapacity( row_count ),
+	mRowsWritten( 0 ),
+	mRows( 0 ),
+	mCommand( NO_COMMAND ),
+	mAddress( NO_ADDRESS )
+{
+	U64 offset = HEADER_SIZE;
+	for( U32 c = 0; c < COLUMN_COUNT; c++ )
+	{
+		mColumnOffsets[ c ] = offset;
+		offset += ( row_count * COLUMN_WIDTHS[ c ] + 7 ) & ~U64( 7 );
+	}
+
+	U8 header[ HEADER_SIZE ] = { 'Q', 'S', 'P', 'I', 'C', 'O', 'L', '1' };
+	const U64 fields[] = { 1 | ( U64( HEADER_SIZE ) << 32 ), sample_rate, trigger_sample, row_count, COLUMN_COUNT, 0, 0,
+		mColumnOffsets[ 0 ], mColumnOffsets[ 1 ], mColumnOffsets[ 2 ], mColumnOffsets[ 3 ],
+		mColumnOffsets[ 4 ], mColumnOffsets[ 5 ], mColumnOffsets[ 6 ], mColumnOffsets[ 7 ] };
+	for( U32 f = 0; f < sizeof( fields ) / sizeof( fields[ 0 ] ); f++ )
+		for( U32 b = 0; b < 8; b++ )
+			header[ 8 + 8 * f + b ] = U8( fields[ f ] >> ( 8 * b ) );
+	mFile.write( ( const char* )header, sizeof( header ) );
+
+	// the padding after the last column, which also sets the file size
+	static const U8 padding[ 8 ] = { 0 };
+	const U64 last_column_end = mColumnOffsets[ COLUMN_COUNT - 1 ] + row_count * COLUMN_WIDTHS[ COLUMN_COUNT - 1 ];
+	mFile.seekp( std::streamoff( last_column_end ) );
+	mFile.write( ( const char* )padding, std::streamsize( offset - last_column_end ) );
+
+	for( U32 c = 0; c < COLUMN_COUNT; c++ )
+		mColumns[ c ].resize( BLOCK_ROWS * COLUMN_WIDTHS[ c ] );
+}
+
+QSPIColumnarExport::~QSPIColumnarExport()
+{
+	WriteBlock();
+
+	if( mRowsWritten != mRowCapacity )
+	{
+		U8 row_count[ 8 ];
+		for( U32 b = 0; b < 8; b++ )
+			row_count[ b ] = U8( mRowsWritten >> ( 8 * b ) );
+		mFile.seekp( ROW_COUNT_OFFSET );
+		mFile.write( ( const char* )row_count, sizeof( row_count ) );
+	}
+}
+
+void QSPIColumnarExport::AddFrame( const Frame& frame )
+{
+	if( mRowsWritten + mRows >= mRowCapacity )
+		return;
+
+	// follow the transaction: a command starts one, an error window ends it
+	U32 address = NO_ADDRESS;
+	U64 data = 0;
+	U32 data_count = 0;
+
+	if( ( frame.mFlags & DISPLAY_AS_ERROR_FLAG ) != 0 )
+	{
+		mCommand = NO_COMMAND;
+		mAddress = NO_ADDRESS;
+	}
+	else
+	{
+		switch( frame.mType )
+		{
+		case FrameTypeCommand:
+			mCommand = U32( frame.mData1 & 0xFF );
+			mAddress = NO_ADDRESS;
+			break;
+		case FrameTypeAddress:
+			mAddress = U32( frame.mData1 );
+			address = mAddress;
+			break;
+		case FrameTypeData:
+			data = frame.mData1;
+			data_count = QSPIAnalyzerResults::GetDataByteCount( frame );
+			address = mAddress;
+			if( mAddress != NO_ADDRESS )
+				mAddress += data_count;
+			break;
+		default:
+			break;
+		}
+	}
+
+	PutLittleEndian( ColumnStartSample, frame.mStartingSampleInclusive, 8 );
+	PutLittleEndian( ColumnEndSample, frame.mEndingSampleInclusive, 8 );
+	PutLittleEndian( ColumnData, data, 8 );
+	PutLittleEndian( ColumnAddress, address, 4 );
+	PutLittleEndian( ColumnCommand, ( frame.mFlags & DISPLAY_AS_ERROR_FLAG ) ? NO_COMMAND : mCommand, 2 );
+	PutLittleEndian( ColumnType, frame.mType, 1 );
+	PutLittleEndian( ColumnDataCount, data_count, 1 );
+	PutLittleEndian( ColumnFlags, frame.mFlags, 1 );
+
+	if( ++mRows == BLOCK_ROWS )
+		WriteBlock();
+}
+
+void QSPIColumnarExport::PutLittleEndian( U32 column, U64 value, U32 width )
+{
+	U8* bytes = &mColumns[ column ][ mRows * width ];
+	for( U32 b = 0; b < width; b++ )
+		bytes[ b ] = U8( value >> ( 8 * b ) );
+}
+
+void QSPIColumnarExport::WriteBlock()
+{
+	if( mRows == 0 )
+		return;
+
+	for( U32 c = 0; c < COLUMN_COUNT; c++ )
+	{
+		mFile.seekp( std::streamoff( mColumnOffsets[ c ] + mRowsWritten * COLUMN_WIDTHS[ c ] ) );
+		mFile.write( ( const char* )&mColumns[ c ][ 0 ], std::streamsize( mRows * COLUMN_WIDTHS[ c ] ) );
+	}
+
+	mRowsWritten += mRows;
+	mRows = 0;
+}
@@ -0,0 +1,65 @@
+#ifndef QSPI_COLUMNAR_EXPORT
+#define QSPI_COLUMNAR_EXPORT
+
+#include <AnalyzerResults.h>
+#include <fstream>
+#include <vector>
+
+// Columnar binary export of the decoded frames, for scripts that would rather map a column than
+// parse text. All values are little endian.
+//
+// Header, 128 bytes:
+//	0	char[8]	magic "QSPICOL1"
+//	8	U32	format version, 1
+//	12	U32	header size in bytes, 128
+//	16	U64	sample rate in Hz
+//	24	U64	trigger sample
+//	32	U64	row count, one row per exported frame
+//	40	U32	column count, 8
+//	44	20 bytes of zeros
+//	64	U64[8]	file offset of each column, in the order below
+//
+// Each column is one contiguous array of row count values, starting on a multiple of 8 bytes so
+// it can be mapped directly as an array of its type:
+//	start_sample	U64	first sample of the frame
+//	end_sample	U64	last sample of the frame
+//	data	U64	data bytes, the first one most significant; 0 for other frames
+//	address	U32	address frames: the address; data frames: the address of their first byte,
+//			counted on from the transaction's address; 0xFFFFFFFF when there is none
+//	command	U16	opcode of the transaction the frame belongs to, 0xFFFF when there is none
+//	type	U8	0 command, 1 address, 2 alternate, 3 dummy, 4 data
+//	data_count	U8	number of bytes in data
+//	flags	U8	frame flags: 0x01 packed data, 0x40 read data that differs from the
+//			flash image, 0x80 error (a chip-select window with the wrong clock polarity, type 0)
+// The columns are laid out for the frame count at the start of the export. An export cancelled
+// part way has a smaller row count, and the space after each column's last row is unused.
+//
+// The SDK's file helpers only append, so the file is written through its own stream: rows are
+// gathered a block at a time and each column's part of the block goes to its place in the file.
+class QSPIColumnarExport
+{
+public:
+	QSPIColumnarExport( const char* file, U64 trigger_sample, U32 sample_rate, U64 row_count );
+	~QSPIColumnarExport(); // writes the last block and the row count
+
+	void AddFrame( const Frame& frame ); // frames past row_count are left out
+
+protected:
+	enum { HEADER_SIZE = 128, ROW_COUNT_OFFSET = 32, BLOCK_ROWS = 65536, COLUMN_COUNT = 8 };
+
+	void PutLittleEndian( U32 column, U64 value, U32 width );
+	void WriteBlock();
+
+	std::ofstream mFile;
+	U64 mRowCapacity;
+	U64 mColumnOffsets[ COLUMN_COUNT ];
+	std::vector<U8> mColumns[ COLUMN_COUNT ];
+	U64 mRowsWritten;
+	U32 mRows; // in the current block
+
+	// the transaction the next frame belongs to
+	U32 mCommand;
+	U32 mAddress;
+};
+
+#endif //QSPI_COLUMNAR_EXPORT
@@ -0,0 +1,329 @@
+#include "QSPIDeviceProfiles.h"
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+namespace
+{
+
+struct QSPICommandDef
+{
+	U8 Opcode;
+	CommandAttr Attr; // AcceptsAddr, UsesDummyCycles, HasData, isWrite, AddressLineMask, DataLineMask, AddressDtr, DataDtr, AddressBytes, DummyCycles, RegisterAddress, Valid
+	const char* Name;
+};
+
+// Micron N25Q
+const QSPICommandDef qspi_generic_commands[] = {
+	{ 0x66, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Reset Enable" },
+	{ 0x99, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Reset Memory" },
+	{ 0x9E, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read Id" },
+	{ 0x9F, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read Id" },
+	{ 0xAF, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Multiple I/O Read Id" },
+	{ 0x5A, { true,true,true,false,0x01,0x02,false,false,3,8,true,true }, "Read Flash Disc Param" }, // JESD216: always 3 address bytes and 8 dummy cycles
+	{ 0x03, { true,false,true,false,0x01,0x02,false,false,0,0,false,true }, "Read" },
+	{ 0x0B, { true,true,true,false,0x01,0x02,false,false,0,0,false,true }, "Fast Read" },
+	{ 0x3B, { true,true,true,false,0x01,0x03,false,false,0,0,false,true }, "Dual Output Fast Read" },
+	{ 0xBB, { true,true,true,false,0x03,0x03,false,false,0,0,false,true }, "Dual I/O Fast Read" },
+	{ 0x6B, { true,true,true,false,0x01,0x0F,false,false,0,0,false,true }, "Quad Output Fast Read" },
+	{ 0xEB, { true,true,true,false,0x0F,0x0F,false,false,0,0,false,true }, "Quad I/O Fast Read" },
+	{ 0x0D, { true,true,true,false,0x01,0x02,true,true,0,0,false,true }, "DTR Fast Read" },
+	{ 0x3D, { true,true,true,false,0x01,0x03,true,true,0,0,false,true }, "DTR Dual Output Fast Read" },
+	{ 0xBD, { true,true,true,false,0x03,0x03,true,true,0,0,false,true }, "DTR Dual I/O Fast Read" },
+	{ 0x6D, { true,true,true,false,0x01,0x0F,true,true,0,0,false,true }, "DTR Quad Output Fast Read" },
+	{ 0xED, { true,true,true,false,0x0F,0x0F,true,true,0,0,false,true }, "DTR Quad I/O Fast Read" },
+	{ 0x8B, { true,true,true,false,0x01,0xFF,false,false,0,0,false,true }, "Octal Output Fast Read" },
+	{ 0xCB, { true,true,true,false,0xFF,0xFF,false,false,0,0,false,true }, "Octal I/O Fast Read" },
+	{ 0x9D, { true,true,true,false,0x01,0xFF,true,true,0,0,false,true }, "DTR Octal Output Fast Read" },
+	{ 0xFD, { true,true,true,false,0xFF,0xFF,true,true,0,0,false,true }, "DTR Octal I/O Fast Read" },
+	{ 0x06, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Write Enable" },
+	{ 0x04, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Write Disable" },
+	{ 0x05, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read Status Reg" },
+	{ 0x01, { false,false,true,true,0x00,0x01,false,false,0,0,false,true }, "Write Status Reg" },
+	{ 0xE8, { true,false,true,false,0x01,0x02,false,false,0,0,true,true }, "Read Lock Reg" },
+	{ 0xE5, { true,false,true,true,0x01,0x01,false,false,0,0,true,true }, "Write Lock Reg" },
+	{ 0x70, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read Flag Status Reg" },
+	{ 0x50, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Clear Flag Status Reg" },
+	{ 0xB5, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read NonVol Cfg Reg" },
+	{ 0xB1, { false,false,true,true,0x00,0x01,false,false,0,0,false,true }, "Write NonVol Cfg Reg" },
+	{ 0x85, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read Vol Cfg Reg" },
+	{ 0x81, { false,false,true,true,0x00,0x01,false,false,0,0,false,true }, "Write Vol Cfg Reg" },
+	{ 0x65, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read En Vol Cfg Reg" },
+	{ 0x61, { false,false,true,true,0x00,0x01,false,false,0,0,false,true }, "Write En Vol Cfg Reg" },
+	{ 0x02, { true,false,true,true,0x01,0x01,false,false,0,0,false,true }, "Page Pgm" },
+	{ 0xA2, { true,false,true,true,0x01,0x03,false,false,0,0,false,true }, "Dual Input Fast Pgm" },
+	{ 0xD2, { true,false,true,true,0x03,0x03,false,false,0,0,false,true }, "Ext Dual Input Fast Pgm" },
+	{ 0x32, { true,false,true,true,0x01,0x0F,false,false,0,0,false,true }, "Quad Input Fast Pgm" },
+	{ 0x12, { true,false,true,true,0x0F,0x0F,false,false,0,0,false,true }, "Ext Quad Input Fast Pgm" },
+	{ 0x38, { true,false,true,true,0x0F,0x0F,false,false,0,0,false,true }, "Quad Page Pgm" },
+	{ 0x82, { true,false,true,true,0x01,0xFF,false,false,0,0,false,true }, "Octal Input Fast Pgm" },
+	{ 0xC2, { true,false,true,true,0xFF,0xFF,false,false,0,0,false,true }, "Ext Octal Input Fast Pgm" },
+	{ 0x20, { true,false,false,false,0x01,0x00,false,false,0,0,false,true }, "Subsector Erase" },
+	{ 0xD8, { true,false,false,false,0x01,0x00,false,false,0,0,false,true }, "Sector Erase" },
+	{ 0xC7, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Bulk Erase" },
+	{ 0x7A, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Pgm/Erase Resume" },
+	{ 0x75, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Pgm/Erase Suspend" },
+	{ 0x4B, { true,true,true,false,0x01,0x02,false,false,0,0,true,true }, "Read OTP Array" },
+	{ 0x42, { true,false,true,true,0x01,0x01,false,false,0,0,true,true }, "Pgm OTP Array" },
+	{ 0xB9, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Deep Power-Down" },
+	{ 0xAB, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Release From DPD" },
+
+	{ 0xFE, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "ERROR, the world is about to end" },
+};
+
+// the JEDEC basics every other profile starts from
+const QSPICommandDef qspi_jedec_commands[] = {
+	{ 0x06, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Write Enable" },
+	{ 0x04, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Write Disable" },
+	{ 0x05, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read Status Reg" },
+	{ 0x01, { false,false,true,true,0x00,0x01,false,false,0,0,false,true }, "Write Status Reg" },
+	{ 0x03, { true,false,true,false,0x01,0x02,false,false,0,0,false,true }, "Read" },
+	{ 0x0B, { true,true,true,false,0x01,0x02,false,false,0,8,false,true }, "Fast Read" },
+	{ 0x3B, { true,true,true,false,0x01,0x03,false,false,0,8,false,true }, "Dual Output Fast Read" },
+	{ 0x6B, { true,true,true,false,0x01,0x0F,false,false,0,8,false,true }, "Quad Output Fast Read" },
+	{ 0xBB, { true,true,true,false,0x03,0x03,false,false,0,4,false,true }, "Dual I/O Fast Read" },
+	{ 0xEB, { true,true,true,false,0x0F,0x0F,false,false,0,6,false,true }, "Quad I/O Fast Read" },
+	{ 0x02, { true,false,true,true,0x01,0x01,false,false,0,0,false,true }, "Page Pgm" },
+	{ 0x20, { true,false,false,false,0x01,0x00,false,false,0,0,false,true }, "Sector Erase" },
+	{ 0x52, { true,false,false,false,0x01,0x00,false,false,0,0,false,true }, "Block Erase 32K" },
+	{ 0xD8, { true,false,false,false,0x01,0x00,false,false,0,0,false,true }, "Block Erase 64K" },
+	{ 0xC7, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Chip Erase" },
+	{ 0x60, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Chip Erase" },
+	{ 0x9F, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read JEDEC Id" },
+	{ 0x90, { true,false,true,false,0x01,0x02,false,false,3,0,true,true }, "Read Mfr/Device Id" },
+	{ 0x5A, { true,true,true,false,0x01,0x02,false,false,3,8,true,true }, "Read SFDP" },
+	{ 0xB9, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Deep Power-Down" },
+	{ 0xAB, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Release From DPD" },
+	{ 0x66, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Reset Enable" },
+	{ 0x99, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Reset Memory" },
+};
+
+// 4 byte address variants, for parts above 128 Mbit
+const QSPICommandDef qspi_four_byte_commands[] = {
+	{ 0x13, { true,false,true,false,0x01,0x02,false,false,4,0,false,true }, "Read 4B" },
+	{ 0x0C, { true,true,true,false,0x01,0x02,false,false,4,8,false,true }, "Fast Read 4B" },
+	{ 0x3C, { true,true,true,false,0x01,0x03,false,false,4,8,false,true }, "Dual Output Fast Read 4B" },
+	{ 0x6C, { true,true,true,false,0x01,0x0F,false,false,4,8,false,true }, "Quad Output Fast Read 4B" },
+	{ 0xBC, { true,true,true,false,0x03,0x03,false,false,4,4,false,true }, "Dual I/O Fast Read 4B" },
+	{ 0xEC, { true,true,true,false,0x0F,0x0F,false,false,4,6,false,true }, "Quad I/O Fast Read 4B" },
+	{ 0x12, { true,false,true,true,0x01,0x01,false,false,4,0,false,true }, "Page Pgm 4B" },
+	{ 0x21, { true,false,false,false,0x01,0x00,false,false,4,0,false,true }, "Sector Erase 4B" },
+	{ 0xDC, { true,false,false,false,0x01,0x00,false,false,4,0,false,true }, "Block Erase 64K 4B" },
+	{ 0xB7, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Enter 4B Address Mode" },
+};
+
+// Winbond W25Q, also used for the GigaDevice GD25Q parts that copy its command set
+const QSPICommandDef qspi_winbond_commands[] = {
+	{ 0x50, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Volatile SR Write Enable" },
+	{ 0x35, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read Status Reg 2" },
+	{ 0x15, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read Status Reg 3" },
+	{ 0x31, { false,false,true,true,0x00,0x01,false,false,0,0,false,true }, "Write Status Reg 2" },
+	{ 0x11, { false,false,true,true,0x00,0x01,false,false,0,0,false,true }, "Write Status Reg 3" },
+	{ 0x32, { true,false,true,true,0x01,0x0F,false,false,0,0,false,true }, "Quad Page Pgm" },
+	{ 0x34, { true,false,true,true,0x01,0x0F,false,false,4,0,false,true }, "Quad Page Pgm 4B" },
+	{ 0x4B, { false,true,true,false,0x00,0x02,false,false,0,32,false,true }, "Read Unique Id" },
+	{ 0x48, { true,true,true,false,0x01,0x02,false,false,3,8,true,true }, "Read Security Reg" },
+	{ 0x42, { true,false,true,true,0x01,0x01,false,false,3,0,true,true }, "Pgm Security Reg" },
+	{ 0x44, { true,false,false,false,0x01,0x00,false,false,3,0,true,true }, "Erase Security Reg" },
+	{ 0x75, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Pgm/Erase Suspend" },
+	{ 0x7A, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Pgm/Erase Resume" },
+	{ 0xE9, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Exit 4B Address Mode" },
+};
+
+// Macronix MX25L
+const QSPICommandDef qspi_macronix_commands[] = {
+	{ 0x38, { true,false,true,true,0x0F,0x0F,false,false,0,0,false,true }, "Quad Page Pgm" },
+	{ 0x3E, { true,false,true,true,0x0F,0x0F,false,false,4,0,false,true }, "Quad Page Pgm 4B" },
+	{ 0x15, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read Config Reg" },
+	{ 0x2B, { false,false,true,false,0x00,0x02,false,false,0,0,false,true }, "Read Security Reg" },
+	{ 0x2F, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Write Security Reg" },
+	{ 0xB1, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Enter Secured OTP" },
+	{ 0xC1, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Exit Secured OTP" },
+	{ 0xB0, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Pgm/Erase Suspend" },
+	{ 0x30, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Pgm/Erase Resume" },
+	{ 0x35, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Enable QPI" },
+	{ 0xF5, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Reset QPI" },
+	{ 0xE9, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Exit 4B Address Mode" },
+};
+
+// ISSI IS25LP
+const QSPICommandDef qspi_issi_commands[] = {
+	{ 0x32, { true,false,true,true,0x01,0x0F,false,false,0,0,false,true }, "Quad Page Pgm" },
+	{ 0x38, { true,false,true,true,0x01,0x0F,false,false,0,0,false,true }, "Quad Page Pgm" },
+	{ 0x34, { true,false,true,true,0x01,0x0F,false,false,4,0,false,true }, "Quad Page Pgm 4B" },
+	{ 0x0D, { true,true,true,false,0x01,0x02,true,true,0,0,false,true }, "DTR Fast Read" },
+	{ 0xBD, { true,true,true,false,0x03,0x03,true,true,0,0,false,true }, "DTR Dual I/O Fast Read" },
+	{ 0xED, { true,true,true,false,0x0F,0x0F,true,true,0,0,false,true }, "DTR Quad I/O Fast Read" },
+	{ 0x35, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Enter QPI" },
+	{ 0xF5, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Exit QPI" },
+	{ 0x75, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Pgm/Erase Suspend" },
+	{ 0x7A, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Pgm/Erase Resume" },
+	{ 0x29, { false,false,false,false,0x00,0x00,false,false,0,0,false,true }, "Exit 4B Address Mode" },
+};
+
+struct QSPICommandList
+{
+	const QSPICommandDef* Defs;
+	U32 Count;
+};
+
+template <U32 N>
+QSPICommandList MakeCommandList(const QSPICommandDef (&defs)[N])
+{
+	QSPICommandList list = { defs, N };
+	return list;
+}
+
+void AddCommandList(QSPICommandSet& commands, const QSPICommandList& list)
+{
+	for (U32 i = 0; i < list.Count; i++)
+		commands.AddCommand(list.Defs[i].Opcode, list.Defs[i].Attr, list.Defs[i].Name);
+}
+
+bool IsLineMask(U32 mask)
+{
+	return (mask == 0x00) || (mask == 0x01) || (mask == 0x02) || (mask == 0x03) || (mask == 0x0F) || (mask == 0xFF);
+}
+
+std::string Trim(const std::string& text)
+{
+	size_t first = text.find_first_not_of(" \t\r");
+	if (first == std::string::npos)
+		return std::string();
+
+	return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+bool ParseNumber(const std::string& field, U32 max, U32& value)
+{
+	char* end = NULL;
+	unsigned long number = strtoul(field.c_str(), &end, 0);
+	if (field.empty() || (*end != '\0') || (number > max))
+		return false;
+
+	value = U32(number);
+	return true;
+}
+
+// parses one line of a profile file; false with error set on a malformed line
+bool ParseCommandLine(const std::string& line, U32& opcode, CommandAttr& attr, std::string& name, std::string& error)
+{
+	std::vector<std::string> fields;
+	std::stringstream stream(line);
+	std::string field;
+	while (std::getline(stream, field, ','))
+		fields.push_back(Trim(field));
+
+	if (fields.size() < 6) {
+		error = "expected opcode, name, address lines, address bytes, dummy cycles, data lines";
+		return false;
+	}
+
+	U32 address_lines, address_bytes = 0, dummy_cycles = 0, data_lines;
+	if (ParseNumber(fields[0], 0xFF, opcode) == false) {
+		error = "opcode must be a number from 0x00 to 0xFF";
+		return false;
+	}
+	if ((ParseNumber(fields[2], 0xFF, address_lines) == false) || (IsLineMask(address_lines) == false) ||
+		(ParseNumber(fields[5], 0xFF, data_lines) == false) || (IsLineMask(data_lines) == false)) {
+		error = "line masks must be 0x00, 0x01, 0x02, 0x03, 0x0F or 0xFF";
+		return false;
+	}
+	if ((fields[3] != "*") && ((ParseNumber(fields[3], 4, address_bytes) == false) || (address_bytes == 0))) {
+		error = "address bytes must be 1 to 4, or *";
+		return false;
+	}
+	if ((fields[4] != "*") && (ParseNumber(fields[4], 32, dummy_cycles) == false)) {
+		error = "dummy cycles must be 0 to 32, or *";
+		return false;
+	}
+
+	attr = CommandAttr{ address_lines != 0, (fields[4] == "*") || (dummy_cycles != 0), data_lines != 0, false, U8(address_lines), U8(data_lines), false, false, U8(address_bytes), U8(dummy_cycles), false, true };
+	for (size_t i = 6; i < fields.size(); i++) {
+		if (fields[i] == "write")
+			attr.isWrite = true;
+		else if (fields[i] == "dtr")
+			attr.AddressDtr = attr.DataDtr = true;
+		else if (fields[i] == "register")
+			attr.RegisterAddress = true;
+		else if (fields[i].empty() == false) {
+			error = "unknown option '" + fields[i] + "', expected write, dtr or register";
+			return false;
+		}
+	}
+
+	name = fields[1];
+	return true;
+}
+
+bool LoadProfileFile(const char* path, QSPICommandSet& commands, std::string& error)
+{
+	std::ifstream file(path);
+	if ((path[0] == '\0') || (file.is_open() == false)) {
+		error = std::string("Cannot open the device profile file '") + path + "'.";
+		return false;
+	}
+
+	std::string line;
+	for (U32 line_number = 1; std::getline(file, line); line_number++) {
+		line = Trim(line.substr(0, line.find('#')));
+		if (line.empty())
+			continue;
+
+		U32 opcode;
+		CommandAttr attr;
+		std::string name;
+		std::string line_error;
+		if (ParseCommandLine(line, opcode, attr, name, line_error) == false) {
+			std::stringstream ss;
+			ss << "Device profile line " << line_number << ": " << line_error << ".";
+			error = ss.str();
+			return false;
+		}
+
+		commands.AddCommand(U8(opcode), attr, name.c_str());
+	}
+
+	if (commands.GetCount() == 0) {
+		error = "The device profile file has no commands.";
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+bool LoadDeviceProfile(U32 profile, const char* path, QSPICommandSet& commands, std::string& error)
+{
+	commands.Clear();
+
+	// later lists override the opcodes of earlier ones
+	switch (profile) {
+	case ProfileWinbond:
+	case ProfileGigaDevice:
+		AddCommandList(commands, MakeCommandList(qspi_jedec_commands));
+		AddCommandList(commands, MakeCommandList(qspi_four_byte_commands));
+		AddCommandList(commands, MakeCommandList(qspi_winbond_commands));
+		return true;
+	case ProfileMacronix:
+		AddCommandList(commands, MakeCommandList(qspi_jedec_commands));
+		AddCommandList(commands, MakeCommandList(qspi_four_byte_commands));
+		AddCommandList(commands, MakeCommandList(qspi_macronix_commands));
+		return true;
+	case ProfileIssi:
+		AddCommandList(commands, MakeCommandList(qspi_jedec_commands));
+		AddCommandList(commands, MakeCommandList(qspi_four_byte_commands));
+		AddCommandList(commands, MakeCommandList(qspi_issi_commands));
+		return true;
+	case ProfileFile:
+		if (LoadProfileFile(path, commands, error))
+			return true;
+		commands.Clear();
+		return false;
+	case ProfileGeneric:
+	default:
+		AddCommandList(commands, MakeCommandList(qspi_generic_commands));
+		return true;
+	}
+}
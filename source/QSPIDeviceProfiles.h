@@ -0,0 +1,25 @@
+#ifndef QSPI_DEVICE_PROFILES
+#define QSPI_DEVICE_PROFILES
+
+#include <string>
+#include "QSPIAnalyzerCommands.h"
+
+enum QSPIDeviceProfile { ProfileGeneric = 0, ProfileWinbond = 1, ProfileMacronix = 2, ProfileIssi = 3, ProfileGigaDevice = 4, ProfileFile = 5 };
+
+// Fills commands with one of the built-in profiles, or with the profile file at path for
+// ProfileFile. A profile file has one command per line, fields separated by commas:
+//
+//	# opcode, name, address lines, address bytes, dummy cycles, data lines[, write][, dtr][, register]
+//	0x0C, Fast Read 4B, 0x01, 4, 8, 0x02
+//	0xEB, Quad I/O Fast Read, 0x0F, *, 6, 0x0F
+//	0x12, Page Pgm 4B, 0x01, 4, 0, 0x01, write
+//	0x48, Read Security Reg, 0x01, 3, 8, 0x02, register
+//
+// Line masks are 0x00 (phase not used), 0x01, 0x02, 0x03, 0x0F or 0xFF; * takes the address
+// size or dummy cycles from the analyzer settings; dtr samples address and data on both edges;
+// register marks an address that is not in the flash array, so the flash image and the address
+// index leave the command out.
+// On failure commands is left empty and error says why.
+bool LoadDeviceProfile(U32 profile, const char* path, QSPICommandSet& commands, std::string& error);
+
+#endif //QSPI_DEVICE_PROFILES
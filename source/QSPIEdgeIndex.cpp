@@ -0,0 +1,136 @@
+#include "QSPIEdgeIndex.h"
+#include <AnalyzerChannelData.h>
+
+QSPIEdgeIndex::QSPIEdgeIndex()
+:	mClockChannel( UNDEFINED_CHANNEL ),
+	mEnableChannel( UNDEFINED_CHANNEL )
+{
+}
+
+QSPIEdgeIndex::~QSPIEdgeIndex()
+{
+}
+
+void QSPIEdgeIndex::Reset( const Channel& clock, const Channel& enable, const Channel* lines, U32 line_count )
+{
+	mClockChannel = clock;
+	mEnableChannel = enable;
+	mLineChannels.assign( lines, lines + line_count );
+
+	Truncate( 0 );
+}
+
+U64 QSPIEdgeIndex::GetWindowCount() const
+{
+	return mWindows.size();
+}
+
+const QSPIEdgeIndex::Window& QSPIEdgeIndex::GetWindow( U64 window_index ) const
+{
+	return mWindows[ size_t( window_index ) ];
+}
+
+void QSPIEdgeIndex::Truncate( U64 window_count )
+{
+	if( window_count >= mWindows.size() )
+		return;
+
+	const Window& first_dropped = mWindows[ size_t( window_count ) ];
+	mDeltas.resize( size_t( first_dropped.mDeltaOffset ) );
+	mLines.resize( size_t( first_dropped.mLinesOffset ) );
+	mWindows.resize( size_t( window_count ) );
+}
+
+void QSPIEdgeIndex::AppendDelta( U64 delta )
+{
+	while( delta >= 0x80 )
+	{
+		mDeltas.push_back( U8( delta | 0x80 ) );
+		delta >>= 7;
+	}
+	mDeltas.push_back( U8( delta ) );
+}
+
+const QSPIEdgeIndex::Window& QSPIEdgeIndex::AddWindow( U64 start, U64 end, AnalyzerChannelData* clock, AnalyzerChannelData* const* lines )
+{
+	Window window;
+	window.mStart = start;
+	window.mEnd = end;
+	window.mDeltaOffset = mDeltas.size();
+	window.mLinesOffset = mLines.size();
+
+	clock->AdvanceToAbsPosition( start );
+	window.mClockStartState = clock->GetBitState();
+
+	// first pass: every clock edge strictly inside the window
+	mScratchEdges.clear();
+	U64 previous = start;
+	while( clock->WouldAdvancingToAbsPositionCauseTransition( end - 1 ) == true )
+	{
+		clock->AdvanceToNextEdge();
+		U64 edge = clock->GetSampleNumber();
+
+		AppendDelta( edge - previous );
+		mScratchEdges.push_back( edge );
+		previous = edge;
+	}
+	window.mEdgeCount = U32( mScratchEdges.size() );
+
+	// each line is walked once across the whole window; between its own transitions a line
+	// costs a compare per clock edge rather than a seek
+	size_t lines_offset = mLines.size();
+	mLines.resize( lines_offset + mScratchEdges.size(), 0 );
+
+	for( U32 line = 0; line < mLineChannels.size(); line++ )
+	{
+		AnalyzerChannelData* data = lines[ line ];
+		if( ( data == NULL ) || mScratchEdges.empty() )
+			continue;
+
+		data->AdvanceToAbsPosition( mScratchEdges.front() );
+		U8 state = ( data->GetBitState() == BIT_HIGH ) ? U8( 1 << line ) : 0;
+		U64 next_transition = data->DoMoreTransitionsExistInCurrentData() ? data->GetSampleOfNextEdge() : end;
+
+		for( size_t i = 0; i < mScratchEdges.size(); i++ )
+		{
+			if( next_transition <= mScratchEdges[i] )
+			{
+				data->AdvanceToAbsPosition( mScratchEdges[i] );
+				state = ( data->GetBitState() == BIT_HIGH ) ? U8( 1 << line ) : 0;
+				next_transition = data->DoMoreTransitionsExistInCurrentData() ? data->GetSampleOfNextEdge() : end;
+			}
+
+			mLines[ lines_offset + i ] |= state;
+		}
+	}
+
+	mWindows.push_back( window );
+	return mWindows.back();
+}
+
+void QSPIEdgeIndex::GetWindowEdges( const Window& window, std::vector<U64>& edges, std::vector<U8>& lines ) const
+{
+	edges.resize( window.mEdgeCount );
+	lines.assign( mLines.begin() + size_t( window.mLinesOffset ), mLines.begin() + size_t( window.mLinesOffset + window.mEdgeCount ) );
+	if( window.mEdgeCount == 0 )
+		return;
+
+	const U8* delta = &mDeltas[0] + window.mDeltaOffset;
+	U64 sample = window.mStart;
+	for( U32 i = 0; i < window.mEdgeCount; i++ )
+	{
+		U64 value = 0;
+		U32 shift = 0;
+		for( ; ; )
+		{
+			U8 byte = *delta++;
+			value |= U64( byte & 0x7F ) << shift;
+			if( ( byte & 0x80 ) == 0 )
+				break;
+			shift += 7;
+		}
+
+		sample += value;
+		edges[i] = sample;
+	}
+}
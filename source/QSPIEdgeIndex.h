@@ -0,0 +1,58 @@
+#ifndef QSPI_EDGE_INDEX
+#define QSPI_EDGE_INDEX
+
+#include <LogicPublicTypes.h>
+#include <AnalyzerTypes.h>
+#include <vector>
+
+class AnalyzerChannelData;
+
+// Clock edges of each chip-select window, recorded in a first pass over the capture so the
+// fields can be decoded by indexing instead of walking the channels bit by bit.
+// The edges are stored as LEB128 varint deltas (one byte each while edges are less than 128
+// samples apart, that is for any clock faster than sample rate / 256), together with one byte
+// per edge holding the DQ lines sampled at that edge (bit n = DQn). The analyzer only keeps the
+// windows waiting to be decoded and truncates the index after each batch; Truncate and Reset keep
+// the buffers, so later batches and reruns do not reallocate them.
+class QSPIEdgeIndex
+{
+public:
+	struct Window
+	{
+		U64 mStart; // active-going enable edge
+		U64 mEnd;   // inactive-going enable edge, clock edges at or after it are not part of the window
+		BitState mClockStartState;
+		U32 mEdgeCount;
+		U64 mDeltaOffset;
+		U64 mLinesOffset;
+	};
+
+	QSPIEdgeIndex();
+	~QSPIEdgeIndex();
+
+	void Reset( const Channel& clock, const Channel& enable, const Channel* lines, U32 line_count );
+
+	U64 GetWindowCount() const;
+	const Window& GetWindow( U64 window_index ) const;
+	void Truncate( U64 window_count );
+
+	// walks the clock from start to end and samples the lines at every clock edge
+	const Window& AddWindow( U64 start, U64 end, AnalyzerChannelData* clock, AnalyzerChannelData* const* lines );
+
+	// expands a window into absolute edge samples and per-edge line samples
+	void GetWindowEdges( const Window& window, std::vector<U64>& edges, std::vector<U8>& lines ) const;
+
+protected:
+	void AppendDelta( U64 delta );
+
+	std::vector<Window> mWindows;
+	std::vector<U8> mDeltas;
+	std::vector<U8> mLines;
+	std::vector<U64> mScratchEdges;
+
+	Channel mClockChannel;
+	Channel mEnableChannel;
+	std::vector<Channel> mLineChannels;
+};
+
+#endif //QSPI_EDGE_INDEX
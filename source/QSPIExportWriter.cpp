@@ -0,0 +1,236 @@
+#include "QSPIExportWriter.h"
+#include <AnalyzerHelpers.h>
+#include <cstring>
+
+static const U32 EXPORT_BUFFER_SIZE = 1 << 20;
+static const U32 MAX_FIELD_LENGTH = 128; // longest single field: a 64 bit binary number
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+static const char decimal_pairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static const char binary_nibbles[] =
+	"00000001001000110100010101100111"
+	"10001001101010111100110111101111";
+
+QSPIExportWriter::QSPIExportWriter( const char* file, U64 trigger_sample, U32 sample_rate, bool is_binary )
+:	mFile( AnalyzerHelpers::StartFile( file, is_binary ) ),
+	mTriggerSample( trigger_sample ),
+	mSampleRate( sample_rate ),
+	mBuffer( EXPORT_BUFFER_SIZE ),
+	mLength( 0 )
+{
+}
+
+QSPIExportWriter::~QSPIExportWriter()
+{
+	Flush();
+	AnalyzerHelpers::EndFile( mFile );
+}
+
+void QSPIExportWriter::AddText( const char* text )
+{
+	const U32 length = U32( strlen( text ) );
+	memcpy( Reserve( length ), text, length );
+	mLength += length;
+}
+
+void QSPIExportWriter::AddChar( char c )
+{
+	*Reserve( 1 ) = c;
+	mLength++;
+}
+
+void QSPIExportWriter::AddBytes( const void* data, U32 length )
+{
+	if( length > EXPORT_BUFFER_SIZE )
+	{
+		Flush();
+		AnalyzerHelpers::AppendToFile( ( const U8* )data, length, mFile );
+		return;
+	}
+
+	memcpy( Reserve( length ), data, length );
+	mLength += length;
+}
+
+void QSPIExportWriter::AddQuotedText( const char* text )
+{
+	AddChar( '"' );
+	for( ; *text != 0; text++ )
+	{
+		if( *text == '"' )
+			AddChar( '"' );
+		AddChar( *text );
+	}
+	AddChar( '"' );
+}
+
+void QSPIExportWriter::AddHexBytes( const U8* bytes, U32 count )
+{
+	// a block at a time, so a long payload never needs more than one buffer's worth
+	while( count > 0 )
+	{
+		const U32 block = ( count < EXPORT_BUFFER_SIZE / 4 ) ? count : EXPORT_BUFFER_SIZE / 4;
+		char* text = Reserve( 2 * block );
+		for( U32 i = 0; i < block; i++ )
+		{
+			text[ 2 * i ] = hex_digits[ bytes[ i ] >> 4 ];
+			text[ 2 * i + 1 ] = hex_digits[ bytes[ i ] & 0x0F ];
+		}
+		mLength += 2 * block;
+		bytes += block;
+		count -= block;
+	}
+}
+
+void QSPIExportWriter::AddTime( U64 sample )
+{
+	const bool negative = sample < mTriggerSample;
+	AddSeconds( negative ? mTriggerSample - sample : sample - mTriggerSample, negative );
+}
+
+void QSPIExportWriter::AddDuration( U64 samples )
+{
+	AddSeconds( samples, false );
+}
+
+void QSPIExportWriter::AddFixedPoint( U64 value, U32 decimals )
+{
+	U64 scale = 1;
+	for( U32 i = 0; i < decimals; i++ )
+		scale *= 10;
+
+	AddUnsigned( value / scale, 1 );
+	if( decimals > 0 )
+	{
+		AddChar( '.' );
+		AddUnsigned( value % scale, decimals );
+	}
+}
+
+void QSPIExportWriter::AddNumber( U64 number, DisplayBase display_base, U32 num_data_bits )
+{
+	if( num_data_bits < 64 )
+		number &= ( 1ULL << num_data_bits ) - 1;
+
+	switch( display_base )
+	{
+	case Hexadecimal:
+	{
+		const U32 digits = ( num_data_bits + 3 ) / 4;
+		char* text = Reserve( digits + 2 );
+		text[ 0 ] = '0';
+		text[ 1 ] = 'x';
+		for( U32 i = 0; i < digits; i++ )
+			text[ 2 + i ] = hex_digits[ ( number >> ( 4 * ( digits - 1 - i ) ) ) & 0x0F ];
+		mLength += digits + 2;
+		break;
+	}
+	case Decimal:
+		AddUnsigned( number, 1 );
+		break;
+	case Binary:
+	{
+		// whole nibbles from the table, then the bits of a partial top nibble
+		char* text = Reserve( num_data_bits + 2 );
+		U32 length = 0;
+		text[ length++ ] = '0';
+		text[ length++ ] = 'b';
+		for( U32 bit = num_data_bits; bit % 4 != 0; bit-- )
+			text[ length++ ] = ( ( number >> ( bit - 1 ) ) & 1 ) ? '1' : '0';
+		for( U32 shift = num_data_bits & ~3U; shift > 0; shift -= 4 )
+		{
+			memcpy( text + length, binary_nibbles + 4 * ( ( number >> ( shift - 4 ) ) & 0x0F ), 4 );
+			length += 4;
+		}
+		mLength += length;
+		break;
+	}
+	default:
+	{
+		// ASCII renderings are left to the SDK
+		char number_str[ MAX_FIELD_LENGTH ];
+		AnalyzerHelpers::GetNumberString( number, display_base, num_data_bits, number_str, sizeof( number_str ) );
+		AddText( number_str );
+		break;
+	}
+	}
+}
+
+void QSPIExportWriter::EndLine()
+{
+	AddChar( '\n' );
+}
+
+void QSPIExportWriter::AddSeconds( U64 samples, bool negative )
+{
+	// the remainder is below the sample rate, so the product stays well inside 64 bits
+	U64 seconds = samples / mSampleRate;
+	U64 nanoseconds = ( ( samples % mSampleRate ) * 1000000000ULL + mSampleRate / 2 ) / mSampleRate;
+	if( nanoseconds == 1000000000ULL )
+	{
+		seconds++;
+		nanoseconds = 0;
+	}
+
+	if( ( negative == true ) && ( ( seconds | nanoseconds ) != 0 ) )
+		AddChar( '-' );
+	AddUnsigned( seconds, 1 );
+	AddChar( '.' );
+	AddUnsigned( nanoseconds, 9 );
+}
+
+void QSPIExportWriter::AddUnsigned( U64 number, U32 min_digits )
+{
+	// two digits per table lookup, written backwards into a scratch buffer
+	char digits[ 24 ];
+	U32 start = sizeof( digits );
+	while( number >= 100 )
+	{
+		start -= 2;
+		memcpy( digits + start, decimal_pairs + 2 * ( number % 100 ), 2 );
+		number /= 100;
+	}
+	if( number >= 10 )
+	{
+		start -= 2;
+		memcpy( digits + start, decimal_pairs + 2 * number, 2 );
+	}
+	else
+	{
+		digits[ --start ] = char( '0' + number );
+	}
+	while( sizeof( digits ) - start < min_digits )
+		digits[ --start ] = '0';
+
+	const U32 length = U32( sizeof( digits ) - start );
+	memcpy( Reserve( length ), digits + start, length );
+	mLength += length;
+}
+
+char* QSPIExportWriter::Reserve( U32 length )
+{
+	if( mLength + length > mBuffer.size() )
+	{
+		Flush();
+		if( length > mBuffer.size() )
+			mBuffer.resize( length );
+	}
+
+	return &mBuffer[ mLength ];
+}
+
+void QSPIExportWriter::Flush()
+{
+	if( mLength == 0 )
+		return;
+
+	AnalyzerHelpers::AppendToFile( ( U8* )&mBuffer[ 0 ], mLength, mFile );
+	mLength = 0;
+}
@@ -0,0 +1,45 @@
+#ifndef QSPI_EXPORT_WRITER
+#define QSPI_EXPORT_WRITER
+
+#include <LogicPublicTypes.h>
+#include <vector>
+
+// Buffered export file output. Rows are formatted straight into one large buffer, which goes to
+// AnalyzerHelpers::AppendToFile a block at a time. Times and the common number bases are
+// formatted with integer arithmetic and digit tables instead of the SDK's generic helpers.
+class QSPIExportWriter
+{
+public:
+	QSPIExportWriter( const char* file, U64 trigger_sample, U32 sample_rate, bool is_binary = false );
+	~QSPIExportWriter(); // writes what is left and closes the file
+
+	void AddText( const char* text );
+	void AddChar( char c );
+	void AddBytes( const void* data, U32 length );
+	void AddQuotedText( const char* text ); // as a CSV field, in double quotes
+	void AddHexBytes( const U8* bytes, U32 count ); // two hex digits per byte, no separators
+
+	// seconds from the trigger sample, rounded to the nanosecond, as "-0.000001230"
+	void AddTime( U64 sample );
+	void AddDuration( U64 samples ); // the same for a number of samples
+	void AddFixedPoint( U64 value, U32 decimals ); // value / 10^decimals, as "12.34" for 1234 and 2
+
+	// same text as AnalyzerHelpers::GetNumberString
+	void AddNumber( U64 number, DisplayBase display_base, U32 num_data_bits );
+
+	void EndLine();
+
+protected:
+	void AddSeconds( U64 samples, bool negative );
+	void AddUnsigned( U64 number, U32 min_digits );
+	char* Reserve( U32 length );
+	void Flush();
+
+	void* mFile;
+	U64 mTriggerSample;
+	U32 mSampleRate;
+	std::vector<char> mBuffer;
+	U32 mLength;
+};
+
+#endif //QSPI_EXPORT_WRITER
@@ -0,0 +1,230 @@
+#include "QSPIFlashImage.h"
+#include <cstring>
+
+static const U64 NO_PAGE_NUMBER = ~U64(0);
+
+struct QSPIEraseCommand
+{
+	U8 mOpcode;
+	U64 mSize; // 0: the whole device
+};
+
+// the JEDEC erase opcodes, which the vendors share
+static const QSPIEraseCommand erase_commands[] = {
+	{ 0x20, 0x1000 }, { 0x21, 0x1000 },
+	{ 0x52, 0x8000 }, { 0x5C, 0x8000 },
+	{ 0xD8, 0x10000 }, { 0xDC, 0x10000 },
+	{ 0xC7, 0 }, { 0x60, 0 },
+};
+
+QSPIFlashImage::Access QSPIFlashImage::GetAccess(U8 command, const CommandAttr& attr)
+{
+	U64 start;
+	U64 end;
+	if (GetEraseRange(command, true, 0, start, end) == true)
+		return AccessErase;
+	if ((attr.Valid == false) || (attr.AcceptsAddr == false) || (attr.HasData == false) || (attr.RegisterAddress == true))
+		return AccessNone;
+
+	return attr.isWrite ? AccessProgram : AccessRead;
+}
+
+bool QSPIFlashImage::GetEraseRange(U8 command, bool has_address, U64 address, U64& start, U64& end)
+{
+	for (U32 i = 0; i < sizeof(erase_commands) / sizeof(erase_commands[0]); i++)
+	{
+		if (erase_commands[i].mOpcode != command)
+			continue;
+
+		const U64 size = erase_commands[i].mSize;
+		if (size == 0)
+		{
+			start = 0;
+			end = ~U64(0);
+			return true;
+		}
+		if (has_address == false)
+			return false;
+
+		start = address & ~(size - 1);
+		end = start + size;
+		return true;
+	}
+
+	return false;
+}
+
+QSPIFlashImage::QSPIFlashImage()
+{
+	Clear();
+}
+
+void QSPIFlashImage::Clear()
+{
+	mPages.clear();
+	mPool.resize(1);
+	memset(mPool[ERASED_PAGE].mData, 0xFF, sizeof(mPool[ERASED_PAGE].mData));
+	memset(mPool[ERASED_PAGE].mKnown, 0xFF, sizeof(mPool[ERASED_PAGE].mKnown));
+	mFreePages.clear();
+	mErasedByDefault = false;
+	mLastPageNumber = NO_PAGE_NUMBER;
+	mLastPage = NO_PAGE;
+}
+
+void QSPIFlashImage::Erase(U64 start, U64 end)
+{
+	if ((start == 0) && (end == ~U64(0)))
+	{
+		EraseAll();
+		return;
+	}
+	if (start >= end)
+		return;
+
+	mLastPageNumber = NO_PAGE_NUMBER;
+	for (U64 page_number = start / PAGE_SIZE; page_number <= (end - 1) / PAGE_SIZE; page_number++)
+	{
+		const U64 page_start = page_number * PAGE_SIZE;
+		const U32 first = (start > page_start) ? U32(start - page_start) : 0;
+		const U32 last = (end - page_start < PAGE_SIZE) ? U32(end - page_start) : U32(PAGE_SIZE);
+
+		if ((first == 0) && (last == PAGE_SIZE))
+		{
+			// the whole page: back to the shared erased page
+			std::map<U64, U32>::iterator page = mPages.find(page_number);
+			if (page != mPages.end())
+			{
+				ReleasePage(page->second);
+				if (mErasedByDefault == true)
+					mPages.erase(page);
+				else
+					page->second = ERASED_PAGE;
+			}
+			else if (mErasedByDefault == false)
+			{
+				mPages[page_number] = ERASED_PAGE;
+			}
+		}
+		else
+		{
+			Page& page = GetWritablePage(page_number);
+			memset(page.mData + first, 0xFF, last - first);
+			for (U32 i = first; i < last; i++)
+				page.mKnown[i / 8] |= U8(1 << (i % 8));
+		}
+	}
+}
+
+void QSPIFlashImage::EraseAll()
+{
+	Clear();
+	mErasedByDefault = true;
+}
+
+void QSPIFlashImage::Program(U64 address, U8 data)
+{
+	Page& page = GetWritablePage(address / PAGE_SIZE);
+	const U32 offset = U32(address % PAGE_SIZE);
+	const U8 known_bit = U8(1 << (offset % 8));
+
+	// programming only clears bits; an unknown byte is taken to have been erased
+	if ((page.mKnown[offset / 8] & known_bit) != 0)
+		page.mData[offset] &= data;
+	else
+		page.mData[offset] = data;
+	page.mKnown[offset / 8] |= known_bit;
+}
+
+bool QSPIFlashImage::Read(U64 address, U8 data)
+{
+	const U32 offset = U32(address % PAGE_SIZE);
+	const U8 known_bit = U8(1 << (offset % 8));
+
+	const U32 index = GetPage(address / PAGE_SIZE);
+	if ((index != NO_PAGE) && ((mPool[index].mKnown[offset / 8] & known_bit) != 0))
+		return mPool[index].mData[offset] == data;
+
+	// the first read of a byte tells what it holds
+	Page& page = GetWritablePage(address / PAGE_SIZE);
+	page.mData[offset] = data;
+	page.mKnown[offset / 8] |= known_bit;
+	return true;
+}
+
+U64 QSPIFlashImage::GetEnd() const
+{
+	if (mPages.empty() == true)
+		return 0;
+
+	return (mPages.rbegin()->first + 1) * PAGE_SIZE;
+}
+
+void QSPIFlashImage::GetBytes(U64 address, U32 count, U8* bytes) const
+{
+	while (count > 0)
+	{
+		const U32 offset = U32(address % PAGE_SIZE);
+		const U32 length = (count < PAGE_SIZE - offset) ? count : PAGE_SIZE - offset;
+
+		// unknown bytes are 0xFF in the pool pages as well
+		const U32 index = GetPage(address / PAGE_SIZE);
+		if (index != NO_PAGE)
+			memcpy(bytes, mPool[index].mData + offset, length);
+		else
+			memset(bytes, 0xFF, length);
+
+		address += length;
+		bytes += length;
+		count -= length;
+	}
+}
+
+U32 QSPIFlashImage::GetPage(U64 page_number) const
+{
+	if (page_number != mLastPageNumber)
+	{
+		std::map<U64, U32>::const_iterator page = mPages.find(page_number);
+		if (page != mPages.end())
+			mLastPage = page->second;
+		else
+			mLastPage = (mErasedByDefault == true) ? U32(ERASED_PAGE) : U32(NO_PAGE);
+		mLastPageNumber = page_number;
+	}
+
+	return mLastPage;
+}
+
+QSPIFlashImage::Page& QSPIFlashImage::GetWritablePage(U64 page_number)
+{
+	const U32 index = GetPage(page_number);
+	if ((index != NO_PAGE) && (index != ERASED_PAGE))
+		return mPool[index];
+
+	U32 new_index;
+	if (mFreePages.empty() == false)
+	{
+		new_index = mFreePages.back();
+		mFreePages.pop_back();
+	}
+	else
+	{
+		new_index = U32(mPool.size());
+		mPool.push_back(Page());
+	}
+
+	// copy on write from the erased page, or start with nothing known
+	Page& page = mPool[new_index];
+	memset(page.mData, 0xFF, sizeof(page.mData));
+	memset(page.mKnown, (index == ERASED_PAGE) ? 0xFF : 0x00, sizeof(page.mKnown));
+
+	mPages[page_number] = new_index;
+	mLastPageNumber = page_number;
+	mLastPage = new_index;
+	return page;
+}
+
+void QSPIFlashImage::ReleasePage(U32 index)
+{
+	if (index != ERASED_PAGE)
+		mFreePages.push_back(index);
+}
@@ -0,0 +1,60 @@
+#ifndef QSPI_FLASH_IMAGE
+#define QSPI_FLASH_IMAGE
+
+#include <LogicPublicTypes.h>
+#include "QSPIAnalyzerCommands.h"
+#include <deque>
+#include <map>
+#include <vector>
+
+// Sparse model of the flash contents, kept up to date from the decoded traffic. The address
+// space is split into 4 KB pages. A page nothing has touched is unknown, or erased after a chip
+// erase. Every erased page shares one read-only page; the first program into it takes a page
+// from the pool and copies the erased contents in. Bytes become known when they are erased,
+// programmed or read; a read of a known byte that returns something else is a mismatch.
+class QSPIFlashImage
+{
+public:
+	enum { PAGE_SIZE = 0x1000, PROGRAM_PAGE_SIZE = 0x100 };
+	enum Access { AccessNone, AccessRead, AccessProgram, AccessErase };
+
+	// what a command does to the flash array; register, OTP and SFDP accesses are AccessNone
+	static Access GetAccess(U8 command, const CommandAttr& attr);
+	// the bytes an erase command clears: its whole granule, or 0 to ~0 for a chip erase
+	static bool GetEraseRange(U8 command, bool has_address, U64 address, U64& start, U64& end);
+
+	QSPIFlashImage();
+
+	void Clear();
+	void Erase(U64 start, U64 end); // sets the bytes start to end - 1 to 0xFF; 0 to ~0 erases all
+	void Program(U64 address, U8 data); // clears the bits data clears, as the flash does
+	bool Read(U64 address, U8 data); // false when the byte is known and differs from data
+
+	// one past the last byte of the last page holding known data; 0 for none
+	U64 GetEnd() const;
+	void GetBytes(U64 address, U32 count, U8* bytes) const; // unknown bytes read as 0xFF
+
+protected:
+	struct Page
+	{
+		U8 mData[PAGE_SIZE];
+		U8 mKnown[PAGE_SIZE / 8]; // bit per byte
+	};
+
+	enum { ERASED_PAGE = 0, NO_PAGE = 0xFFFFFFFF }; // the shared erased page in mPool; an unknown page
+
+	void EraseAll();
+	U32 GetPage(U64 page_number) const; // its pool index
+	Page& GetWritablePage(U64 page_number);
+	void ReleasePage(U32 index);
+
+	std::map<U64, U32> mPages; // page number to pool index
+	std::deque<Page> mPool; // pages never move as it grows
+	std::vector<U32> mFreePages;
+	bool mErasedByDefault; // after a chip erase, the unlisted pages are erased rather than unknown
+
+	mutable U64 mLastPageNumber; // the page the last access went to, since accesses run in address order
+	mutable U32 mLastPage;
+};
+
+#endif //QSPI_FLASH_IMAGE
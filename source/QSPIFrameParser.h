@@ -0,0 +1,202 @@
+#ifndef QSPI_FRAME_PARSER
+#define QSPI_FRAME_PARSER
+
+#include <LogicPublicTypes.h>
+#include "QSPIAnalyzerSettings.h"
+#include "QSPIAnalyzerResults.h"
+#include "QSPIAnalyzerCommands.h"
+#include "QSPISfdp.h"
+
+// The transaction layer shared by the streaming analyzer and QSPIWindowDecoder. A DECODER
+// supplies the bit level: GetWord<LINE_MASK, DTR>(num_bits), GetDataByte<LINE_MASK, DTR>(), GetDummy(cycles),
+// SaveResults(...), SavePackedData(...), AbandonTransaction(), SaveSfdpByte(address, data),
+// FinishSfdpRead(), mSettings and mCommands, the command set in effect.
+
+struct QSPIParseResult {
+	S64 start;
+	S64 end;
+	U64 data;
+};
+
+inline bool IsParseResultError(const QSPIParseResult& result)
+{
+	// a single DTR sample (an octal byte) starts and ends on the same edge
+	if (result.start >= 0 && result.end >= result.start) {
+		return false;
+	}
+	else {
+		return true;
+	}
+}
+
+// Lines carrying every field in the dual, quad and octal modes; extended mode sends the command
+// on DQ0 and takes the address and data lines from the command table.
+static constexpr U32 ModeLineMask(U32 mode)
+{
+	return mode == ModeStateOctal ? 0xFF : (mode == ModeStateQuad ? 0x0F : (mode == ModeStateDual ? 0x03 : 0x01));
+}
+
+static constexpr U32 CountLines(U32 line_mask)
+{
+	return line_mask == 0 ? 0 : (line_mask & 0x01) + CountLines(line_mask >> 1);
+}
+
+static constexpr U32 LowestLine(U32 line_mask)
+{
+	return (line_mask & 0x01) ? 0 : 1 + LowestLine(line_mask >> 1);
+}
+
+// dtr: the field is sampled on both clock edges rather than on the leading edge only
+template <class DECODER, U32 MODE>
+QSPIParseResult GetQSPIField(DECODER& decoder, int CommandLineMask, U32 num_bits, bool dtr)
+{
+	// extended mode: the command decides the lines, resolved once per field rather than per edge
+	const U32 line_mask = (MODE != ModeStateExtended) ? ModeLineMask(MODE) : U32(CommandLineMask);
+
+	switch (line_mask) {
+	case 0xFF: return dtr ? decoder.template GetWord<0xFF, true>(num_bits) : decoder.template GetWord<0xFF, false>(num_bits);
+	case 0x0F: return dtr ? decoder.template GetWord<0x0F, true>(num_bits) : decoder.template GetWord<0x0F, false>(num_bits);
+	case 0x03: return dtr ? decoder.template GetWord<0x03, true>(num_bits) : decoder.template GetWord<0x03, false>(num_bits);
+	case 0x02: return dtr ? decoder.template GetWord<0x02, true>(num_bits) : decoder.template GetWord<0x02, false>(num_bits);
+	case 0x01:
+	default: return dtr ? decoder.template GetWord<0x01, true>(num_bits) : decoder.template GetWord<0x01, false>(num_bits);
+	}
+}
+
+// the data phase runs to the end of the transaction, which lets a decoder read its bytes ahead
+template <class DECODER, U32 MODE>
+QSPIParseResult GetQSPIDataByte(DECODER& decoder, int DataLineMask, bool dtr)
+{
+	const U32 line_mask = (MODE != ModeStateExtended) ? ModeLineMask(MODE) : U32(DataLineMask);
+
+	switch (line_mask) {
+	case 0xFF: return dtr ? decoder.template GetDataByte<0xFF, true>() : decoder.template GetDataByte<0xFF, false>();
+	case 0x0F: return dtr ? decoder.template GetDataByte<0x0F, true>() : decoder.template GetDataByte<0x0F, false>();
+	case 0x03: return dtr ? decoder.template GetDataByte<0x03, true>() : decoder.template GetDataByte<0x03, false>();
+	case 0x02: return dtr ? decoder.template GetDataByte<0x02, true>() : decoder.template GetDataByte<0x02, false>();
+	case 0x01:
+	default: return dtr ? decoder.template GetDataByte<0x01, true>() : decoder.template GetDataByte<0x01, false>();
+	}
+}
+
+template <class DECODER, U32 MODE, U32 ADDRESS_BYTES>
+void ParseQSPIFrame(DECODER& decoder)
+{
+	QSPIParseResult currentCommand;
+
+	CommandAttr currentCommandAttr;
+
+	// the opcode has to be read before its table entry is known, so only the DTR protocol
+	// setting can put the command phase on both edges
+	const bool dtr_protocol = (decoder.mSettings->mDtrProtocol != 0);
+
+	// Get Command
+	currentCommand = GetQSPIField<DECODER, MODE>(decoder, ModeLineMask(MODE), 8, dtr_protocol);
+
+	if(IsParseResultError(currentCommand)) {
+        return;
+    }
+    else {
+        decoder.SaveResults(currentCommand, FrameTypeCommand);
+
+        if (decoder.mCommands.IsValid(currentCommand.data)==false) { //if command byte is not valid, skip forward to end of active edge
+            decoder.AbandonTransaction();
+            return;
+        }
+    }
+
+	currentCommandAttr = decoder.mCommands.GetAttr(currentCommand.data);
+
+
+	// the data of SFDP reads goes to the decoder by SFDP address, see QSPISfdp
+	const bool sfdp_read = (currentCommand.data == SFDP_READ_OPCODE) && (decoder.mSettings->mSfdpAutoSetup != 0);
+	U32 sfdp_address = 0;
+
+	// Get Address
+
+	if (currentCommandAttr.AcceptsAddr) {
+		QSPIParseResult currentAddress;
+		const U32 address_bytes = currentCommandAttr.AddressBytes ? currentCommandAttr.AddressBytes : ADDRESS_BYTES; // the profile fixes the size of some commands
+
+		currentAddress = GetQSPIField<DECODER, MODE>(decoder, currentCommandAttr.AddressLineMask, address_bytes * 8, dtr_protocol || currentCommandAttr.AddressDtr);
+
+		if(IsParseResultError(currentAddress)) {
+            return;
+		}
+        else {
+            decoder.SaveResults(currentAddress, FrameTypeAddress, address_bytes);
+            sfdp_address = U32(currentAddress.data);
+        }
+
+	}
+
+	// Get Dummy bits
+
+	if (currentCommandAttr.UsesDummyCycles) {
+		QSPIParseResult currentDummy;
+		currentDummy = decoder.GetDummy(currentCommandAttr.DummyCycles ? currentCommandAttr.DummyCycles : decoder.mSettings->mDummyCycles);
+		if(IsParseResultError(currentDummy)) {
+            return;
+		}
+        else {
+            decoder.SaveResults(currentDummy, FrameTypeDummy);
+        }
+
+	}
+
+	// Get Data
+	if (currentCommandAttr.HasData) {
+		const int data_lines = (MODE == ModeStateExtended) ? currentCommandAttr.DataLineMask : ModeLineMask(MODE);
+		const bool pack_data = (decoder.mSettings->mDataBytesPerFrame > 1);
+		const bool data_dtr = dtr_protocol || currentCommandAttr.DataDtr;
+
+		for (;;) {
+			QSPIParseResult currentData;
+
+			currentData = GetQSPIDataByte<DECODER, MODE>(decoder, currentCommandAttr.DataLineMask, data_dtr);
+
+            if(IsParseResultError(currentData)) {
+                if (sfdp_read)
+                    decoder.FinishSfdpRead();
+                return; // any packed bytes were flushed when the enable edge ended the transaction
+            }
+
+            if (sfdp_read)
+                decoder.SaveSfdpByte(sfdp_address++, U8(currentData.data));
+
+            if (pack_data) {
+                decoder.SavePackedData(currentData, data_lines);
+            }
+            else {
+                decoder.SaveResults(currentData, FrameTypeData);
+            }
+		}
+	}
+}
+
+template <class DECODER>
+struct QSPIFrameParser
+{
+	typedef void (*Parser)(DECODER& decoder);
+
+	// The mode and address size are fixed for the whole run, so pick the matching ParseQSPIFrame
+	// instance once instead of switching on the settings for every field.
+	static Parser Select(U32 mode, U32 address_size)
+	{
+		bool four_byte_address = (address_size == 4);
+
+		switch (mode) {
+		case ModeStateDual:
+			return four_byte_address ? &ParseQSPIFrame<DECODER, ModeStateDual, 4> : &ParseQSPIFrame<DECODER, ModeStateDual, 3>;
+		case ModeStateQuad:
+			return four_byte_address ? &ParseQSPIFrame<DECODER, ModeStateQuad, 4> : &ParseQSPIFrame<DECODER, ModeStateQuad, 3>;
+		case ModeStateOctal:
+			return four_byte_address ? &ParseQSPIFrame<DECODER, ModeStateOctal, 4> : &ParseQSPIFrame<DECODER, ModeStateOctal, 3>;
+		case ModeStateExtended:
+		default:
+			return four_byte_address ? &ParseQSPIFrame<DECODER, ModeStateExtended, 4> : &ParseQSPIFrame<DECODER, ModeStateExtended, 3>;
+		}
+	}
+};
+
+#endif //QSPI_FRAME_PARSER
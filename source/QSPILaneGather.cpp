@@ -0,0 +1,230 @@
+#include "QSPILaneGather.h"
+#include "QSPIFrameParser.h"
+#include <cstring>
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define QSPI_LANE_GATHER_SSE2
+#include <emmintrin.h>
+#endif
+#if defined( __GNUC__ ) || defined( __clang__ ) || defined( __AVX2__ )
+#define QSPI_LANE_GATHER_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+// GCC and Clang build the AVX2 kernel whatever the target flags and pick it at run time;
+// other compilers only when the whole build targets AVX2.
+#if defined( QSPI_LANE_GATHER_AVX2 ) && !defined( __AVX2__ )
+#define QSPI_AVX2_FUNCTION __attribute__( ( target( "avx2" ) ) )
+#else
+#define QSPI_AVX2_FUNCTION
+#endif
+
+template <U32 LINE_MASK, U32 STRIDE>
+static void GatherScalar( const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	const U32 lines_used = CountLines( LINE_MASK );
+	const U32 samples = 8 / lines_used;
+
+	for( U32 b = 0; b < byte_count; b++ )
+	{
+		U32 byte = 0;
+		for( U32 i = 0; i < samples; i++ )
+			byte = ( byte << lines_used ) | ( ( edge_lines[ STRIDE * i ] & LINE_MASK ) >> LowestLine( LINE_MASK ) );
+
+		bytes[ b ] = U8( byte );
+		edge_lines += STRIDE * samples;
+	}
+}
+
+// Quad SDR: byte k is ( edge_lines[4k] & 0x0F ) << 4 | ( edge_lines[4k + 2] & 0x0F ). Seen as 32 bit
+// little endian words, both nibbles sit in one word, at bits 0-3 and 16-19, so a mask and two
+// shifts leave the byte in the low 8 bits of each word; the packs then narrow the words to bytes.
+// Quad DTR is the same on 16 bit words, with the nibbles at bits 0-3 and 8-11. Octal has one
+// sample per byte: SDR keeps the even edge bytes, and DTR is a plain copy.
+
+#ifdef QSPI_LANE_GATHER_SSE2
+static inline __m128i GatherQuadWordsSse2( const U8* edge_lines )
+{
+	__m128i nibbles = _mm_and_si128( _mm_loadu_si128( ( const __m128i* )edge_lines ), _mm_set1_epi32( 0x000F000F ) );
+	__m128i words = _mm_or_si128( _mm_slli_epi32( nibbles, 4 ), _mm_srli_epi32( nibbles, 16 ) );
+	return _mm_and_si128( words, _mm_set1_epi32( 0xFF ) );
+}
+
+static U32 GatherQuadSse2( const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	U32 b = 0;
+	for( ; b + 16 <= byte_count; b += 16, edge_lines += 64 )
+	{
+		__m128i low = _mm_packs_epi32( GatherQuadWordsSse2( edge_lines ), GatherQuadWordsSse2( edge_lines + 16 ) );
+		__m128i high = _mm_packs_epi32( GatherQuadWordsSse2( edge_lines + 32 ), GatherQuadWordsSse2( edge_lines + 48 ) );
+		_mm_storeu_si128( ( __m128i* )( bytes + b ), _mm_packus_epi16( low, high ) );
+	}
+	return b;
+}
+
+static inline __m128i GatherQuadDtrWordsSse2( const U8* edge_lines )
+{
+	__m128i nibbles = _mm_and_si128( _mm_loadu_si128( ( const __m128i* )edge_lines ), _mm_set1_epi16( 0x0F0F ) );
+	__m128i words = _mm_or_si128( _mm_slli_epi16( nibbles, 4 ), _mm_srli_epi16( nibbles, 8 ) );
+	return _mm_and_si128( words, _mm_set1_epi16( 0xFF ) );
+}
+
+static U32 GatherQuadDtrSse2( const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	U32 b = 0;
+	for( ; b + 16 <= byte_count; b += 16, edge_lines += 32 )
+		_mm_storeu_si128( ( __m128i* )( bytes + b ), _mm_packus_epi16( GatherQuadDtrWordsSse2( edge_lines ), GatherQuadDtrWordsSse2( edge_lines + 16 ) ) );
+	return b;
+}
+
+static U32 GatherOctalSse2( const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	const __m128i even = _mm_set1_epi16( 0xFF );
+
+	U32 b = 0;
+	for( ; b + 16 <= byte_count; b += 16, edge_lines += 32 )
+	{
+		__m128i low = _mm_and_si128( _mm_loadu_si128( ( const __m128i* )edge_lines ), even );
+		__m128i high = _mm_and_si128( _mm_loadu_si128( ( const __m128i* )( edge_lines + 16 ) ), even );
+		_mm_storeu_si128( ( __m128i* )( bytes + b ), _mm_packus_epi16( low, high ) );
+	}
+	return b;
+}
+#endif
+
+#ifdef QSPI_LANE_GATHER_AVX2
+QSPI_AVX2_FUNCTION static inline __m256i GatherQuadWordsAvx2( const U8* edge_lines )
+{
+	__m256i nibbles = _mm256_and_si256( _mm256_loadu_si256( ( const __m256i* )edge_lines ), _mm256_set1_epi32( 0x000F000F ) );
+	__m256i words = _mm256_or_si256( _mm256_slli_epi32( nibbles, 4 ), _mm256_srli_epi32( nibbles, 16 ) );
+	return _mm256_and_si256( words, _mm256_set1_epi32( 0xFF ) );
+}
+
+QSPI_AVX2_FUNCTION static U32 GatherQuadAvx2( const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	// the packs work within each 128 bit half, which leaves the 4 byte groups in the order
+	// 0 2 4 6 1 3 5 7; the permute puts them back in sequence
+	const __m256i order = _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7 );
+
+	U32 b = 0;
+	for( ; b + 32 <= byte_count; b += 32, edge_lines += 128 )
+	{
+		__m256i low = _mm256_packs_epi32( GatherQuadWordsAvx2( edge_lines ), GatherQuadWordsAvx2( edge_lines + 32 ) );
+		__m256i high = _mm256_packs_epi32( GatherQuadWordsAvx2( edge_lines + 64 ), GatherQuadWordsAvx2( edge_lines + 96 ) );
+		__m256i packed = _mm256_permutevar8x32_epi32( _mm256_packus_epi16( low, high ), order );
+		_mm256_storeu_si256( ( __m256i* )( bytes + b ), packed );
+	}
+	return b;
+}
+
+QSPI_AVX2_FUNCTION static inline __m256i GatherQuadDtrWordsAvx2( const U8* edge_lines )
+{
+	__m256i nibbles = _mm256_and_si256( _mm256_loadu_si256( ( const __m256i* )edge_lines ), _mm256_set1_epi16( 0x0F0F ) );
+	__m256i words = _mm256_or_si256( _mm256_slli_epi16( nibbles, 4 ), _mm256_srli_epi16( nibbles, 8 ) );
+	return _mm256_and_si256( words, _mm256_set1_epi16( 0xFF ) );
+}
+
+QSPI_AVX2_FUNCTION static U32 GatherQuadDtrAvx2( const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	U32 b = 0;
+	for( ; b + 32 <= byte_count; b += 32, edge_lines += 64 )
+	{
+		// the pack leaves the 8 byte groups in the order 0 2 1 3
+		__m256i packed = _mm256_packus_epi16( GatherQuadDtrWordsAvx2( edge_lines ), GatherQuadDtrWordsAvx2( edge_lines + 32 ) );
+		_mm256_storeu_si256( ( __m256i* )( bytes + b ), _mm256_permute4x64_epi64( packed, 0xD8 ) );
+	}
+	return b;
+}
+
+static bool CpuHasAvx2()
+{
+#if defined( __AVX2__ )
+	return true;
+#else
+	static const bool has_avx2 = __builtin_cpu_supports( "avx2" ) != 0;
+	return has_avx2;
+#endif
+}
+#endif
+
+static void GatherQuad( const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	U32 done = 0;
+
+#ifdef QSPI_LANE_GATHER_AVX2
+	if( CpuHasAvx2() == true )
+		done = GatherQuadAvx2( edge_lines, byte_count, bytes );
+#endif
+#ifdef QSPI_LANE_GATHER_SSE2
+	done += GatherQuadSse2( edge_lines + 4 * done, byte_count - done, bytes + done );
+#endif
+
+	GatherScalar<0x0F, 2>( edge_lines + 4 * done, byte_count - done, bytes + done );
+}
+
+static void GatherQuadDtr( const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	U32 done = 0;
+
+#ifdef QSPI_LANE_GATHER_AVX2
+	if( CpuHasAvx2() == true )
+		done = GatherQuadDtrAvx2( edge_lines, byte_count, bytes );
+#endif
+#ifdef QSPI_LANE_GATHER_SSE2
+	done += GatherQuadDtrSse2( edge_lines + 2 * done, byte_count - done, bytes + done );
+#endif
+
+	GatherScalar<0x0F, 1>( edge_lines + 2 * done, byte_count - done, bytes + done );
+}
+
+static void GatherOctal( const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	U32 done = 0;
+
+#ifdef QSPI_LANE_GATHER_SSE2
+	done = GatherOctalSse2( edge_lines, byte_count, bytes );
+#endif
+
+	GatherScalar<0xFF, 2>( edge_lines + 2 * done, byte_count - done, bytes + done );
+}
+
+void GatherLaneBytes( U32 line_mask, bool dtr, const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	if( line_mask == 0xFF )
+	{
+		if( dtr == true )
+			memcpy( bytes, edge_lines, byte_count );
+		else
+			GatherOctal( edge_lines, byte_count, bytes );
+	}
+	else if( line_mask != 0x0F )
+		GatherLaneBytesScalar( line_mask, dtr, edge_lines, byte_count, bytes );
+	else if( dtr == true )
+		GatherQuadDtr( edge_lines, byte_count, bytes );
+	else
+		GatherQuad( edge_lines, byte_count, bytes );
+}
+
+template <U32 STRIDE>
+static void GatherScalar( U32 line_mask, const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	switch( line_mask )
+	{
+	case 0xFF: GatherScalar<0xFF, STRIDE>( edge_lines, byte_count, bytes ); break;
+	case 0x0F: GatherScalar<0x0F, STRIDE>( edge_lines, byte_count, bytes ); break;
+	case 0x03: GatherScalar<0x03, STRIDE>( edge_lines, byte_count, bytes ); break;
+	case 0x02: GatherScalar<0x02, STRIDE>( edge_lines, byte_count, bytes ); break;
+	case 0x01:
+	default: GatherScalar<0x01, STRIDE>( edge_lines, byte_count, bytes ); break;
+	}
+}
+
+void GatherLaneBytesScalar( U32 line_mask, bool dtr, const U8* edge_lines, U32 byte_count, U8* bytes )
+{
+	if( dtr == true )
+		GatherScalar<1>( line_mask, edge_lines, byte_count, bytes );
+	else
+		GatherScalar<2>( line_mask, edge_lines, byte_count, bytes );
+}
@@ -0,0 +1,18 @@
+#ifndef QSPI_LANE_GATHER
+#define QSPI_LANE_GATHER
+
+#include <LogicPublicTypes.h>
+
+// Builds data bytes from raw per-edge line samples, laid out as QSPIEdgeIndex stores them: one
+// byte per clock edge with bit n = DQn, edge_lines[0] being the leading edge of the first cycle.
+// SDR samples the leading (every other) edges, DTR samples every edge. The bit order matches
+// the MsbFirst gather of the decoders: the lines in line_mask are taken highest line first, and
+// earlier edges end up in the higher bits of each byte. edge_lines must hold
+// byte_count * 8 / (lines in line_mask) entries for DTR, twice that for SDR.
+//
+// GatherLaneBytes uses AVX2 or SSE2 for the quad and octal lines where the CPU has them, and
+// falls back to GatherLaneBytesScalar otherwise.
+void GatherLaneBytes( U32 line_mask, bool dtr, const U8* edge_lines, U32 byte_count, U8* bytes );
+void GatherLaneBytesScalar( U32 line_mask, bool dtr, const U8* edge_lines, U32 byte_count, U8* bytes );
+
+#endif //QSPI_LANE_GATHER
@@ -0,0 +1,138 @@
+#include "QSPISfdp.h"
+#include "QSPIAnalyzerSettings.h"
+#include <algorithm>
+#include <cstring>
+
+// SFDP tables are a few hundred bytes; reads beyond this are not SFDP data worth keeping
+static const U32 SFDP_MAX_ADDRESS = 0x10000;
+static const U32 SFDP_SIGNATURE = 0x50444653; // "SFDP", little endian
+
+// a fast read field of the basic flash parameter table: [4:0] wait states, [7:5] mode clocks, [15:8] opcode
+static bool ConfigureFastRead(QSPICommandSet& commands, U32 field, U8 address_lines, U8 data_lines)
+{
+	const U8 opcode = U8(field >> 8);
+	const U32 cycles = std::min<U32>((field & 0x1F) + ((field >> 5) & 0x07), 32); // mode clocks are dummy cycles to the decoder
+	if ((opcode == 0x00) || (commands.IsValid(opcode) == false))
+		return false;
+
+	CommandAttr attr = commands.GetAttr(opcode);
+	attr.AcceptsAddr = true;
+	attr.HasData = true;
+	attr.isWrite = false;
+	attr.AddressLineMask = address_lines;
+	attr.DataLineMask = data_lines;
+	attr.UsesDummyCycles = (cycles != 0);
+	attr.DummyCycles = U8(cycles);
+
+	if (memcmp(&attr, &commands.GetAttr(opcode), sizeof(attr)) == 0)
+		return false;
+
+	commands.SetAttr(opcode, attr);
+	return true;
+}
+
+QSPISfdp::QSPISfdp()
+{
+}
+
+QSPISfdp::~QSPISfdp()
+{
+}
+
+void QSPISfdp::Reset()
+{
+	mData.clear();
+	mKnown.clear();
+}
+
+void QSPISfdp::AddByte(U32 address, U8 data)
+{
+	if (address >= SFDP_MAX_ADDRESS)
+		return;
+
+	if (address >= mData.size())
+	{
+		mData.resize(address + 1, 0x00);
+		mKnown.resize(address + 1, 0);
+	}
+
+	mData[address] = data;
+	mKnown[address] = 1;
+}
+
+bool QSPISfdp::GetDword(U32 address, U32& dword) const
+{
+	if (address + 4 > mData.size())
+		return false;
+
+	dword = 0;
+	for (U32 i = 4; i-- > 0; )
+	{
+		if (mKnown[address + i] == 0)
+			return false;
+		dword = (dword << 8) | mData[address + i];
+	}
+
+	return true;
+}
+
+bool QSPISfdp::Configure(QSPICommandSet& commands, U32 mode) const
+{
+	// SFDP header, then the first parameter header, which is always the basic flash parameter table
+	U32 signature, parameter_id, parameter_pointer;
+	if ((GetDword(0x00, signature) == false) || (signature != SFDP_SIGNATURE))
+		return false;
+	if ((GetDword(0x08, parameter_id) == false) || (GetDword(0x0C, parameter_pointer) == false))
+		return false;
+	if (((parameter_id & 0xFF) != 0x00) || ((parameter_id >> 24) < 7)) // ID LSB, length in dwords
+		return false;
+
+	const U32 table = parameter_pointer & 0xFFFFFF;
+	U32 dword[8]; // dword[n] is the 1-based DWORD n of the table
+	for (U32 n = 1; n <= 7; n++)
+		if (GetDword(table + 4 * (n - 1), dword[n]) == false)
+			return false; // not read yet
+
+	bool changed = false;
+
+	// address bytes [18:17]: 0 three byte only, 1 three or four, 2 four byte only
+	const U32 address_mode = (dword[1] >> 17) & 0x03;
+	if ((address_mode == 0) || (address_mode == 2))
+	{
+		for (U64 i = 0; i < commands.GetCount(); i++)
+		{
+			const U8 opcode = U8(commands.GetCommand(i));
+			CommandAttr attr = commands.GetAttr(opcode);
+			if ((attr.AcceptsAddr == false) || (attr.AddressBytes != 0))
+				continue;
+
+			attr.AddressBytes = (address_mode == 0) ? 3 : 4;
+			commands.SetAttr(opcode, attr);
+			changed = true;
+		}
+	}
+
+	switch (mode)
+	{
+	case ModeStateExtended:
+		if (dword[1] & (1 << 16))
+			changed |= ConfigureFastRead(commands, dword[4] & 0xFFFF, 0x01, 0x03); // 1-1-2
+		if (dword[1] & (1 << 20))
+			changed |= ConfigureFastRead(commands, dword[4] >> 16, 0x03, 0x03); // 1-2-2
+		if (dword[1] & (1 << 21))
+			changed |= ConfigureFastRead(commands, dword[3] & 0xFFFF, 0x0F, 0x0F); // 1-4-4
+		if (dword[1] & (1 << 22))
+			changed |= ConfigureFastRead(commands, dword[3] >> 16, 0x01, 0x0F); // 1-1-4
+		break;
+	case ModeStateDual:
+		if (dword[5] & (1 << 0))
+			changed |= ConfigureFastRead(commands, dword[6] >> 16, 0x03, 0x03); // 2-2-2
+		break;
+	case ModeStateQuad:
+		if (dword[5] & (1 << 4))
+			changed |= ConfigureFastRead(commands, dword[7] >> 16, 0x0F, 0x0F); // 4-4-4
+		break;
+	}
+
+	return changed;
+}
@@ -0,0 +1,42 @@
+#ifndef QSPI_SFDP
+#define QSPI_SFDP
+
+#include <LogicPublicTypes.h>
+#include <vector>
+#include "QSPIAnalyzerCommands.h"
+
+const U8 SFDP_READ_OPCODE = 0x5A;
+
+// Serial Flash Discoverable Parameters (JESD216) seen on the bus. The bytes of every SFDP read
+// are collected by their SFDP address, so the header and the basic flash parameter table may come
+// in separate reads and in any order. Once the table is complete, Configure applies the address
+// width and the fast read dummy cycles it lists to a command set.
+class QSPISfdp
+{
+public:
+	struct Byte
+	{
+		U32 mAddress;
+		U8 mData;
+	};
+
+	QSPISfdp();
+	~QSPISfdp();
+
+	void Reset();
+	void AddByte(U32 address, U8 data);
+
+	// Applies the basic flash parameter table to the commands the device already has: the address
+	// width for commands that take it from the settings, and the lanes and dummy cycles of the fast
+	// reads of the bus protocol in mode (1-1-2, 1-2-2, 1-1-4 and 1-4-4 in Extended mode, 2-2-2 in
+	// Dual, 4-4-4 in Quad). Returns true when any command changed.
+	bool Configure(QSPICommandSet& commands, U32 mode) const;
+
+protected:
+	bool GetDword(U32 address, U32& dword) const;
+
+	std::vector<U8> mData; // SFDP address space, up to the highest address read
+	std::vector<U8> mKnown; // 1 where mData holds a byte read from the device
+};
+
+#endif //QSPI_SFDP
@@ -1,8 +1,10 @@
 #include "QSPISimulationDataGenerator.h"
 #include "QSPIAnalyzerSettings.h"
 #include "QSPIAnalyzerCommands.h"
+#include "QSPISfdp.h"
 
 #include <AnalyzerHelpers.h>
+#include <algorithm>
 
 QSPISimulationDataGenerator::QSPISimulationDataGenerator()
 :	mSerialText( "garbage!" ),
@@ -25,6 +27,10 @@ void QSPISimulationDataGenerator::Initialize(U32 simulation_sample_rate, QSPIAna
 	mDQ1 = mQSPISimulationChannels.Add(settings->mDQ1Channel, mSimulationSampleRateHz, BIT_LOW);
 	mDQ2 = mQSPISimulationChannels.Add(settings->mDQ2Channel, mSimulationSampleRateHz, BIT_LOW);
 	mDQ3 = mQSPISimulationChannels.Add(settings->mDQ3Channel, mSimulationSampleRateHz, BIT_LOW);
+	mDQ4 = mQSPISimulationChannels.Add(settings->mDQ4Channel, mSimulationSampleRateHz, BIT_LOW);
+	mDQ5 = mQSPISimulationChannels.Add(settings->mDQ5Channel, mSimulationSampleRateHz, BIT_LOW);
+	mDQ6 = mQSPISimulationChannels.Add(settings->mDQ6Channel, mSimulationSampleRateHz, BIT_LOW);
+	mDQ7 = mQSPISimulationChannels.Add(settings->mDQ7Channel, mSimulationSampleRateHz, BIT_LOW);
 	mClock = mQSPISimulationChannels.Add(settings->mClockChannel, mSimulationSampleRateHz, mSettings->mClockInactiveState);
 	mEnable = mQSPISimulationChannels.Add(settings->mEnableChannel, mSimulationSampleRateHz, BIT_LOW);
 
@@ -40,9 +46,19 @@ U32 QSPISimulationDataGenerator::GenerateSimulationData( U64 largest_sample_requ
 
 	while( mClock->GetCurrentSampleNumber() < adjusted_largest_sample_requested )
 	{
-		for (U64 i = 0; i<40; i++) {
+		const U64 command_count = std::min<U64>(40, mSettings->mCommands.GetCount());
+		for (U64 i = 0; i<command_count; i++) {
 			U64 dataarray[] = { 0xDE, 0xAD, 0xBE, 0xEF };
-			CreateQSPITransaction(GetQSPICommand(i), 0xBEADED, dataarray, sizeof(dataarray) / sizeof(U64), mSettings->mModeState);
+			const U64 command = mSettings->mCommands.GetCommand(i);
+			if (command == SFDP_READ_OPCODE) {
+				// the whole SFDP table, describing the simulated device
+				std::vector<U64> sfdp;
+				BuildSfdpTable(sfdp);
+				CreateQSPITransaction(command, 0x000000, &sfdp[0], int(sfdp.size()), mSettings->mModeState);
+			}
+			else {
+				CreateQSPITransaction(command, 0xBEADED, dataarray, sizeof(dataarray) / sizeof(U64), mSettings->mModeState);
+			}
 			mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(20.0)); //insert idle
 		}
 		
@@ -61,46 +77,46 @@ void QSPISimulationDataGenerator::CreateQSPITransaction(U64 command, U64 address
 
 	mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(2.0));
 
-	// Convert the address string to three address bytes
-	U32 address0 = (address >> 16) & 0xFF;
-	U32 address1 = (address >> 8) & 0xFF;
-	U32 address2 = (address) & 0xFF;
+	const CommandAttr& attr = mSettings->mCommands.GetAttr(command);
+
+	// DTR protocol puts every phase on both edges, DTR commands only their address and data
+	const bool command_dtr = (mSettings->mDtrProtocol != 0);
+	const bool address_dtr = command_dtr || attr.AddressDtr;
+	const bool data_dtr = command_dtr || attr.DataDtr;
 
 	// Send the command byte
 	switch (modestate) {
-	case 1 : OutputWord(command, 0x01); //Extended mode
+	case 1 : OutputWord(command, 0x01, command_dtr); //Extended mode
+		break;
+	case 2 : OutputWord(command, 0x03, command_dtr); //Dual mode
 		break;
-	case 2 : OutputWord(command, 0x03); //Dual mode
+	case 3: OutputWord(command, 0x0F, command_dtr); //Quad mode
 		break;
-	case 3: OutputWord(command, 0x0F); //Quad mode
+	case 4: OutputWord(command, 0xFF, command_dtr); //Octal mode
 		break;
 	}
 
-	// Send the 3 address bytes
-	if (GetQSPICommandAttr(command).AcceptsAddr) {
+	// Send the address bytes, as many as the profile or the Address Size setting asks for
+	if (attr.AcceptsAddr) {
+		const U32 address_bytes = attr.AddressBytes ? attr.AddressBytes : mSettings->mAddressSize;
+		int address_lines = attr.AddressLineMask;
 		switch (modestate) {
-		case 1: //Extended Mode
-			OutputWord(address0, GetQSPICommandAttr(command).AddressLineMask);
-			OutputWord(address1, GetQSPICommandAttr(command).AddressLineMask);
-			OutputWord(address2, GetQSPICommandAttr(command).AddressLineMask);
+		case 2: address_lines = 0x03; //Dual mode
 			break;
-		case 2: //Dual mode
-			OutputWord(address0, 0x03);
-			OutputWord(address1, 0x03);
-			OutputWord(address2, 0x03);
+		case 3: address_lines = 0x0F; //Quad mode
 			break;
-		case 3: //Quad mode
-			OutputWord(address0, 0x0F);
-			OutputWord(address1, 0x0F);
-			OutputWord(address2, 0x0F);
+		case 4: address_lines = 0xFF; //Octal mode
 			break;
 		}
+
+		for (U32 i = address_bytes; i > 0; i--)
+			OutputWord((address >> (8 * (i - 1))) & 0xFF, address_lines, address_dtr);
 	}
 
 	// Clock the dummy bits
-	if (GetQSPICommandAttr(command).UsesDummyCycles) {
-		//OutputWord(0x00, 0x01);  // potentially a problem.  this needs to be 8 clock cycles not 8 bits.  some commands require 10 clock cycles.
-		for (U32 i = 0; i<mSettings->mDummyCycles; i++)
+	if (attr.UsesDummyCycles) {
+		const U32 dummy_cycles = attr.DummyCycles ? attr.DummyCycles : mSettings->mDummyCycles;
+		for (U32 i = 0; i<dummy_cycles; i++)
 		{
 			mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
 			mClock->Transition();  //data valid
@@ -111,26 +127,31 @@ void QSPISimulationDataGenerator::CreateQSPITransaction(U64 command, U64 address
 	}
 
 	// Send / recieve the data
-	if (GetQSPICommandAttr(command).HasData) {
+	if (attr.HasData) {
 		switch (modestate) {
 		case 1: //Extended Mode
-			if (GetQSPICommandAttr(command).isWrite) {
+			if (attr.isWrite || (command == SFDP_READ_OPCODE)) {
 				for (int i = 0; i<datasize; i++) {
-					OutputWord(data[i], GetQSPICommandAttr(command).DataLineMask);
+					OutputWord(data[i], attr.DataLineMask, data_dtr);
 				}
 			}
 			else {
-				OutputWord(0xAA, GetQSPICommandAttr(command).DataLineMask);
+				OutputWord(0xAA, attr.DataLineMask, data_dtr);
 			}
 			break;
 		case 2: //Dual mode
 			for (int i = 0; i<datasize; i++) {
-				OutputWord(data[i], 0x03);
+				OutputWord(data[i], 0x03, data_dtr);
 			}
 			break;
 		case 3: //Quad mode
 			for (int i = 0; i<datasize; i++) {
-				OutputWord(data[i], 0x0F);
+				OutputWord(data[i], 0x0F, data_dtr);
+			}
+			break;
+		case 4: //Octal mode
+			for (int i = 0; i<datasize; i++) {
+				OutputWord(data[i], 0xFF, data_dtr);
 			}
 			break;
 		}
@@ -139,6 +160,12 @@ void QSPISimulationDataGenerator::CreateQSPITransaction(U64 command, U64 address
 
 	}
 
+	// An octal DTR phase with an odd byte count stops half way through a clock cycle
+	if (mClock->GetCurrentBitState() != mSettings->mClockInactiveState) {
+		mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
+		mClock->Transition();
+	}
+
 	// End Transaction
 	if (mEnable != NULL)
 		mEnable->TransitionIfNeeded(BIT_HIGH);
@@ -146,7 +173,48 @@ void QSPISimulationDataGenerator::CreateQSPITransaction(U64 command, U64 address
 }
 
 
-void QSPISimulationDataGenerator::OutputWord(U64 data, int pinmask)
+void QSPISimulationDataGenerator::BuildSfdpTable(std::vector<U64>& table)
+{
+	// JESD216: SFDP header and one parameter header pointing at a 9 dword basic flash parameter table at 0x10
+	const U32 fast_read_112 = GetSfdpFastRead(0x3B);
+	const U32 fast_read_122 = GetSfdpFastRead(0xBB);
+	const U32 fast_read_144 = GetSfdpFastRead(0xEB);
+	const U32 fast_read_114 = GetSfdpFastRead(0x6B);
+	const U32 fast_read_222 = (mSettings->mModeState == ModeStateDual) ? GetSfdpFastRead(0xBB) : 0;
+	const U32 fast_read_444 = (mSettings->mModeState == ModeStateQuad) ? GetSfdpFastRead(0xEB) : 0;
+
+	U32 dwords[] = {
+		0x50444653, 0xFF000106, // "SFDP", revision 1.6, one parameter header
+		0x09010600, 0xFF000010, // basic flash parameter table, revision 1.6, 9 dwords at 0x10
+		0xFF8020E5 | ((fast_read_112 != 0) << 16) | ((mSettings->mAddressSize == 4) ? (2 << 17) : 0) |
+			((fast_read_122 != 0) << 20) | ((fast_read_144 != 0) << 21) | ((fast_read_114 != 0) << 22),
+		0x07FFFFFF, // 128 Mbit
+		fast_read_144 | (fast_read_114 << 16),
+		fast_read_112 | (fast_read_122 << 16),
+		U32(fast_read_222 != 0) | (U32(fast_read_444 != 0) << 4),
+		fast_read_222 << 16,
+		fast_read_444 << 16,
+		0xD810200C, // 4 KB erase 0x20, 64 KB erase 0xD8
+		0x00000000,
+	};
+
+	table.clear();
+	for (U32 i = 0; i < sizeof(dwords) / sizeof(dwords[0]); i++)
+		for (U32 b = 0; b < 4; b++)
+			table.push_back((dwords[i] >> (8 * b)) & 0xFF);
+}
+
+U32 QSPISimulationDataGenerator::GetSfdpFastRead(U8 opcode)
+{
+	// a fast read field of the basic flash parameter table: wait states, no mode clocks, opcode
+	const CommandAttr& attr = mSettings->mCommands.GetAttr(opcode);
+	if ((attr.Valid == false) || (attr.HasData == false) || (attr.UsesDummyCycles == false))
+		return 0;
+
+	return (U32(opcode) << 8) | std::min<U32>(attr.DummyCycles ? attr.DummyCycles : mSettings->mDummyCycles, 0x1F);
+}
+
+void QSPISimulationDataGenerator::OutputWord(U64 data, int pinmask, bool dtr)
 {
 	// this currently produces garbage data (not valid qspi)
 
@@ -160,11 +228,7 @@ void QSPISimulationDataGenerator::OutputWord(U64 data, int pinmask)
 				if (mDQ0 != NULL)
 					mDQ0->TransitionIfNeeded(data_bits.GetNextBit());
 
-				mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
-				mClock->Transition();  //data valid
-
-				mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
-				mClock->Transition();  //data invalid
+				ClockOutSample(dtr);
 			}
       break;
     case 0x02: // using DQ1
@@ -173,11 +237,7 @@ void QSPISimulationDataGenerator::OutputWord(U64 data, int pinmask)
 			if (mDQ1 != NULL)
 				mDQ1->TransitionIfNeeded(data_bits.GetNextBit());
 
-			mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
-			mClock->Transition();  //data valid
-
-			mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
-			mClock->Transition();  //data invalid
+			ClockOutSample(dtr);
 		}
       break;
 
@@ -188,10 +248,7 @@ void QSPISimulationDataGenerator::OutputWord(U64 data, int pinmask)
 					mDQ1->TransitionIfNeeded(data_bits.GetNextBit());
 				if (mDQ0 != NULL)
 					mDQ0->TransitionIfNeeded(data_bits.GetNextBit());
-				mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
-				mClock->Transition();  //data valid
-				mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
-				mClock->Transition();  //data invalid
+				ClockOutSample(dtr);
 			}
 
       break;
@@ -207,10 +264,19 @@ void QSPISimulationDataGenerator::OutputWord(U64 data, int pinmask)
 				if (mDQ0 != NULL)
 					mDQ0->TransitionIfNeeded(data_bits.GetNextBit());
 
-				mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
-				mClock->Transition();  //data valid
-				mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
-				mClock->Transition();  //data invalid
+				ClockOutSample(dtr);
+			}
+      break;
+    case 0xFF: // using DQ0 through DQ7, one byte per sample
+			{
+				SimulationChannelDescriptor* lines[8] = { mDQ7, mDQ6, mDQ5, mDQ4, mDQ3, mDQ2, mDQ1, mDQ0 };
+				for (U32 i = 0; i<8; i++)
+				{
+					if (lines[i] != NULL)
+						lines[i]->TransitionIfNeeded(data_bits.GetNextBit());
+				}
+
+				ClockOutSample(dtr);
 			}
   }
 
@@ -227,5 +293,34 @@ void QSPISimulationDataGenerator::OutputWord(U64 data, int pinmask)
 	if (mDQ3 != NULL)
 		mDQ3->TransitionIfNeeded(BIT_LOW);
 
+	if (mDQ4 != NULL)
+		mDQ4->TransitionIfNeeded(BIT_LOW);
+
+	if (mDQ5 != NULL)
+		mDQ5->TransitionIfNeeded(BIT_LOW);
+
+	if (mDQ6 != NULL)
+		mDQ6->TransitionIfNeeded(BIT_LOW);
+
+	if (mDQ7 != NULL)
+		mDQ7->TransitionIfNeeded(BIT_LOW);
+
 	mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(1.0));
 }
+
+void QSPISimulationDataGenerator::ClockOutSample(bool dtr)
+{
+	if (dtr) {
+		// one edge per sample, halfway between the data changes
+		mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.25));
+		mClock->Transition();  //data valid
+		mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.25));
+	}
+	else {
+		mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
+		mClock->Transition();  //data valid
+
+		mQSPISimulationChannels.AdvanceAll(mClockGenerator.AdvanceByHalfPeriod(.5));
+		mClock->Transition();  //data invalid
+	}
+}
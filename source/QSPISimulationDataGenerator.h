@@ -2,6 +2,7 @@
 #define QSPI_SIMULATION_DATA_GENERATOR
 
 #include <AnalyzerHelpers.h>
+#include <vector>
 
 class QSPIAnalyzerSettings;
 
@@ -23,7 +24,10 @@ protected:
 	ClockGenerator mClockGenerator;
 
 	void CreateQSPITransaction(U64 command, U64 address, U64 data[], int datasize, int modestate);
-	void OutputWord(U64 data, int pinmask);
+	void BuildSfdpTable(std::vector<U64>& table);
+	U32 GetSfdpFastRead(U8 opcode);
+	void OutputWord(U64 data, int pinmask, bool dtr = false);
+	void ClockOutSample(bool dtr);
 
 	std::string mSerialText;
 	U32 mStringIndex;
@@ -33,6 +37,10 @@ protected:
 	SimulationChannelDescriptor* mDQ1;
 	SimulationChannelDescriptor* mDQ2;
 	SimulationChannelDescriptor* mDQ3;
+	SimulationChannelDescriptor* mDQ4;
+	SimulationChannelDescriptor* mDQ5;
+	SimulationChannelDescriptor* mDQ6;
+	SimulationChannelDescriptor* mDQ7;
 	SimulationChannelDescriptor* mClock;
 	SimulationChannelDescriptor* mEnable;
 
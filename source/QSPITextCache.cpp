@@ -0,0 +1,90 @@
+#include "QSPITextCache.h"
+#include <cstring>
+
+void QSPITextCache::Entry::AddString(const char* part1, const char* part2, const char* part3, const char* part4)
+{
+	if (mStringCount >= MAX_STRINGS)
+		return;
+
+	char* string = mStrings[mStringCount++];
+	const char* parts[] = { part1, part2, part3, part4 };
+	U32 length = 0;
+	for (U32 p = 0; p < 4; p++)
+	{
+		for (const char* c = parts[p]; (c != NULL) && (*c != '\0') && (length < MAX_STRING_LENGTH - 1); c++)
+			string[length++] = *c;
+	}
+	string[length] = '\0';
+}
+
+void QSPITextCache::Entry::AppendToLastString(const char* part)
+{
+	if (mStringCount == 0)
+		return;
+
+	char* string = mStrings[mStringCount - 1];
+	U32 length = U32(strlen(string));
+	for (const char* c = part; (*c != '\0') && (length < MAX_STRING_LENGTH - 1); c++)
+		string[length++] = *c;
+	string[length] = '\0';
+}
+
+QSPITextCache::QSPITextCache()
+{
+	Clear();
+}
+
+QSPITextCache::~QSPITextCache()
+{
+}
+
+void QSPITextCache::Clear()
+{
+	for (U32 i = 0; i < SETS * WAYS; i++)
+	{
+		mEntries[i].mKey = 0;
+		mEntries[i].mLastUse = 0;
+	}
+	mUseCount = 0;
+}
+
+const QSPITextCache::Entry* QSPITextCache::Find(U64 frame_index, DisplayBase display_base, TextKind kind)
+{
+	const U32 key = MakeKey(display_base, kind);
+	Entry* set = GetSet(frame_index);
+	for (U32 way = 0; way < WAYS; way++)
+	{
+		if ((set[way].mKey == key) && (set[way].mFrameIndex == frame_index))
+		{
+			set[way].mLastUse = ++mUseCount;
+			return &set[way];
+		}
+	}
+
+	return NULL;
+}
+
+QSPITextCache::Entry* QSPITextCache::Insert(U64 frame_index, DisplayBase display_base, TextKind kind)
+{
+	// the unused or least recently used way of the set
+	Entry* set = GetSet(frame_index);
+	Entry* entry = &set[0];
+	for (U32 way = 0; way < WAYS; way++)
+	{
+		if (set[way].mKey == 0)
+		{
+			entry = &set[way];
+			break;
+		}
+
+		// unsigned differences keep the order right when mUseCount wraps
+		if (mUseCount - set[way].mLastUse > mUseCount - entry->mLastUse)
+			entry = &set[way];
+	}
+
+	entry->mFrameIndex = frame_index;
+	entry->mKey = MakeKey(display_base, kind);
+	entry->mLastUse = ++mUseCount;
+	entry->mStringCount = 0;
+	return entry;
+}
@@ -0,0 +1,47 @@
+#ifndef QSPI_TEXT_CACHE
+#define QSPI_TEXT_CACHE
+
+#include <LogicPublicTypes.h>
+
+// Bubble and tabular strings of the frames drawn most recently, so a redraw of the same view
+// formats nothing. Frames never change once added, so entries are only dropped to make room:
+// the cache is 4-way set associative on the frame index, least recently used first out, and
+// fixed in size, so neither a lookup nor a new entry allocates.
+class QSPITextCache
+{
+public:
+	enum TextKind { BubbleText = 0, TabularText = 1 };
+	enum { MAX_STRINGS = 3, MAX_STRING_LENGTH = 128 };
+
+	struct Entry
+	{
+		U64 mFrameIndex;
+		U32 mKey; // display base and text kind, 0 while the entry is unused
+		U32 mLastUse;
+		U32 mStringCount;
+		char mStrings[MAX_STRINGS][MAX_STRING_LENGTH];
+
+		// adds the concatenation of the parts as the next string, cut to MAX_STRING_LENGTH - 1 characters
+		void AddString(const char* part1, const char* part2 = NULL, const char* part3 = NULL, const char* part4 = NULL);
+		void AppendToLastString(const char* part); // same limit
+	};
+
+	QSPITextCache();
+	~QSPITextCache();
+
+	void Clear();
+
+	const Entry* Find(U64 frame_index, DisplayBase display_base, TextKind kind);
+	Entry* Insert(U64 frame_index, DisplayBase display_base, TextKind kind); // an empty entry to fill in
+
+protected:
+	enum { SETS = 64, WAYS = 4 };
+
+	U32 MakeKey(DisplayBase display_base, TextKind kind) const { return 1 + U32(display_base) * 2 + U32(kind); }
+	Entry* GetSet(U64 frame_index) { return &mEntries[(frame_index % SETS) * WAYS]; }
+
+	Entry mEntries[SETS * WAYS];
+	U32 mUseCount;
+};
+
+#endif //QSPI_TEXT_CACHE
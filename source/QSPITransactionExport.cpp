@@ -0,0 +1,95 @@
+#include "QSPITransactionExport.h"
+#include "QSPIAnalyzerResults.h"
+#include "QSPIAnalyzerCommands.h"
+
+QSPITransactionExport::QSPITransactionExport( const char* file, U64 trigger_sample, U32 sample_rate, const QSPICommandSet& commands,
+	DisplayBase display_base, U32 address_size )
+:	mWriter( file, trigger_sample, sample_rate ),
+	mCommands( commands ),
+	mDisplayBase( display_base ),
+	mAddressSize( address_size ),
+	mActive( false ),
+	mStart( 0 ),
+	mEnd( 0 ),
+	mCommand( 0 ),
+	mHasAddress( false ),
+	mAddress( 0 ),
+	mAddressBits( 0 )
+{
+	mWriter.AddText( "Start [s],End [s],Command,Name,Address,Bytes,Data" );
+	mWriter.EndLine();
+}
+
+QSPITransactionExport::~QSPITransactionExport()
+{
+	WriteTransaction();
+}
+
+void QSPITransactionExport::AddFrame( const Frame& frame )
+{
+	if( ( frame.mFlags & DISPLAY_AS_ERROR_FLAG ) != 0 )
+	{
+		WriteTransaction();
+		return;
+	}
+
+	if( frame.mType == FrameTypeCommand )
+	{
+		WriteTransaction();
+
+		mActive = true;
+		mStart = frame.mStartingSampleInclusive;
+		mCommand = U8( frame.mData1 );
+		mHasAddress = false;
+		mPayload.clear();
+	}
+	else if( mActive == false )
+	{
+		return;
+	}
+
+	mEnd = frame.mEndingSampleInclusive;
+
+	switch( frame.mType )
+	{
+	case FrameTypeAddress:
+		mHasAddress = true;
+		mAddress = frame.mData1;
+		mAddressBits = 8 * ( ( frame.mData2 != 0 ) ? U32( frame.mData2 ) : mAddressSize );
+		break;
+	case FrameTypeData:
+	{
+		const U32 byte_count = QSPIAnalyzerResults::GetDataByteCount( frame );
+		for( U32 b = 0; b < byte_count; b++ )
+			mPayload.push_back( QSPIAnalyzerResults::GetDataByte( frame, b ) );
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void QSPITransactionExport::WriteTransaction()
+{
+	if( mActive == false )
+		return;
+
+	mWriter.AddTime( mStart );
+	mWriter.AddChar( ',' );
+	mWriter.AddTime( mEnd );
+	mWriter.AddChar( ',' );
+	mWriter.AddNumber( mCommand, mDisplayBase, 8 );
+	mWriter.AddChar( ',' );
+	mWriter.AddQuotedText( mCommands.GetName( mCommand ) );
+	mWriter.AddChar( ',' );
+	if( mHasAddress == true )
+		mWriter.AddNumber( mAddress, mDisplayBase, mAddressBits );
+	mWriter.AddChar( ',' );
+	mWriter.AddNumber( mPayload.size(), Decimal, 32 );
+	mWriter.AddChar( ',' );
+	if( mPayload.empty() == false )
+		mWriter.AddHexBytes( &mPayload[ 0 ], U32( mPayload.size() ) );
+	mWriter.EndLine();
+
+	mActive = false;
+}
@@ -0,0 +1,43 @@
+#ifndef QSPI_TRANSACTION_EXPORT
+#define QSPI_TRANSACTION_EXPORT
+
+#include <AnalyzerResults.h>
+#include <vector>
+#include "QSPIExportWriter.h"
+
+class QSPICommandSet;
+
+// Text export with one row per transaction instead of one per frame:
+//	Start [s],End [s],Command,Name,Address,Bytes,Data
+// A transaction runs from a command frame to the next command or error frame. The address is
+// left empty for commands without one, and Data holds the payload as plain hex digits. Windows
+// with the wrong clock polarity have no transaction and are left out.
+class QSPITransactionExport
+{
+public:
+	QSPITransactionExport( const char* file, U64 trigger_sample, U32 sample_rate, const QSPICommandSet& commands,
+		DisplayBase display_base, U32 address_size );
+	~QSPITransactionExport(); // writes the last transaction
+
+	void AddFrame( const Frame& frame );
+
+protected:
+	void WriteTransaction();
+
+	QSPIExportWriter mWriter;
+	const QSPICommandSet& mCommands;
+	DisplayBase mDisplayBase;
+	U32 mAddressSize; // for address frames that do not hold their own
+
+	// the transaction being collected
+	bool mActive;
+	U64 mStart;
+	U64 mEnd;
+	U8 mCommand;
+	bool mHasAddress;
+	U64 mAddress;
+	U32 mAddressBits;
+	std::vector<U8> mPayload;
+};
+
+#endif //QSPI_TRANSACTION_EXPORT
@@ -0,0 +1,281 @@
+#include "QSPIWindowDecoder.h"
+#include "QSPILaneGather.h"
+#include <algorithm>
+
+QSPIWindowDecoder::QSPIWindowDecoder()
+:	mSettings(NULL),
+	mGlitchSamples(0),
+	mFrameParser(NULL),
+	mEdge(0),
+	mFrameEdge(0),
+	mDataByte(0),
+	mDataEdge(0),
+	mPendingDataBytes(0),
+	mPendingDataLines(0)
+{
+}
+
+QSPIWindowDecoder::~QSPIWindowDecoder()
+{
+}
+
+void QSPIWindowDecoder::Setup(const QSPIAnalyzerSettings* settings, U64 glitch_samples)
+{
+	mSettings = settings;
+	mGlitchSamples = glitch_samples;
+	mCommands = settings->mCommands;
+	mFrameParser = QSPIFrameParser<QSPIWindowDecoder>::Select(mSettings->mModeState, mSettings->mAddressSize);
+	mPendingDataBytes = 0;
+}
+
+void QSPIWindowDecoder::SetCommands(const QSPICommandSet& commands)
+{
+	mCommands = commands;
+}
+
+void QSPIWindowDecoder::DecodeWindow(const QSPIEdgeIndex& index, const QSPIEdgeIndex::Window& window)
+{
+	mFrames.clear();
+	mMarkers.clear();
+	mSfdpBytes.clear();
+	index.GetWindowEdges(window, mEdges, mLines);
+	mDataBytes.clear();
+	mDataByte = 0;
+	mDataEdge = 0;
+	mFrameEdge = 0;
+	mClockStats.Clear();
+
+	if (mGlitchSamples != 0)
+		FilterClockGlitches();
+
+	for (mEdge = 0; mEdge < mEdges.size(); )
+		mFrameParser(*this);
+
+	FlushPackedData();
+	TakeShortestPeriod();
+	mClockStats.GetSummary(mClockSummary);
+}
+
+std::vector<Frame>& QSPIWindowDecoder::GetFrames()
+{
+	return mFrames;
+}
+
+std::vector<QSPIWindowDecoder::Marker>& QSPIWindowDecoder::GetMarkers()
+{
+	return mMarkers;
+}
+
+std::vector<QSPISfdp::Byte>& QSPIWindowDecoder::GetSfdpBytes()
+{
+	return mSfdpBytes;
+}
+
+const QSPIClockStats::Summary& QSPIWindowDecoder::GetClockSummary() const
+{
+	return mClockSummary;
+}
+
+U64 QSPIWindowDecoder::TakeShortestPeriod()
+{
+	// the edges the fields took since the last frame, the same ones the streaming decoder has seen by then
+	if (mEdge > mFrameEdge)
+		mClockStats.AddEdges(&mEdges[mFrameEdge], mEdge - mFrameEdge);
+	mFrameEdge = mEdge;
+
+	return mClockStats.TakeShortestPeriod();
+}
+
+template <U32 LINE_MASK, bool DTR>
+QSPIParseResult QSPIWindowDecoder::GetWord(U32 num_bits)
+{
+	const U32 lines_used = CountLines(LINE_MASK);
+	const U32 samples = num_bits / lines_used;
+	const U32 stride = DTR ? 1 : 2;
+
+	// SDR: every bit needs its leading and trailing edge inside the window; DTR: one edge per bit
+	if (mEdge + stride * samples > mEdges.size())
+		return AbandonField(samples, stride);
+
+	AddArrowMarkers(samples, stride, true);
+
+	U64 word = 0;
+	const U8* lines = &mLines[mEdge];
+	for (U32 i = 0; i < samples; i++)
+	{
+		// SDR data is valid on AnalyzerEnums::LeadingEdge of clock, i.e. every other edge
+		word = (word << lines_used) | ((lines[stride * i] & LINE_MASK) >> LowestLine(LINE_MASK));
+	}
+
+	QSPIParseResult return_value;
+	return_value.start = mEdges[mEdge];
+	return_value.end = mEdges[mEdge + stride * samples - 1];
+	return_value.data = word;
+
+	mEdge += stride * samples;
+	return return_value;
+}
+
+template <U32 LINE_MASK, bool DTR>
+QSPIParseResult QSPIWindowDecoder::GetDataByte()
+{
+	const U32 samples = 8 / CountLines(LINE_MASK);
+	const U32 stride = DTR ? 1 : 2;
+	const U32 edges_per_byte = stride * samples;
+
+	if ((mDataEdge != mEdge) || (mDataByte >= mDataBytes.size()))
+	{
+		// first byte of the data phase: gather every whole byte left in the window
+		U32 byte_count = U32((mEdges.size() - mEdge) / edges_per_byte);
+		if (byte_count == 0)
+			return AbandonField(samples, stride);
+
+		mDataBytes.resize(byte_count);
+		GatherLaneBytes(LINE_MASK, DTR, &mLines[mEdge], byte_count, &mDataBytes[0]);
+		mDataByte = 0;
+	}
+
+	AddArrowMarkers(samples, stride, true);
+
+	QSPIParseResult return_value;
+	return_value.start = mEdges[mEdge];
+	return_value.end = mEdges[mEdge + edges_per_byte - 1];
+	return_value.data = mDataBytes[mDataByte++];
+
+	mEdge += edges_per_byte;
+	mDataEdge = mEdge;
+	return return_value;
+}
+
+QSPIParseResult QSPIWindowDecoder::GetDummy(U32 cycles)
+{
+	if (mEdge + 2 * cycles > mEdges.size())
+		return AbandonField(cycles, 2);
+
+	AddArrowMarkers(cycles, 2, true);
+
+	QSPIParseResult return_value;
+	return_value.start = mEdges[mEdge];
+	return_value.end = mEdges[mEdge + 2 * cycles - 1];
+	return_value.data = 0x00;
+
+	mEdge += 2 * cycles;
+	return return_value;
+}
+
+void QSPIWindowDecoder::FilterClockGlitches()
+{
+	// the streaming rule on the whole window: an edge followed by another within the filter starts
+	// a glitch, and both go
+	const U32 edge_count = U32(mEdges.size());
+	U32 kept = 0;
+	for (U32 i = 0; i < edge_count; )
+	{
+		if ((i + 1 < edge_count) && (mEdges[i + 1] - mEdges[i] < mGlitchSamples))
+		{
+			mClockStats.AddGlitch();
+			if (mSettings->mMarkerDetail != MarkersOff)
+			{
+				Marker marker = { mEdges[i], AnalyzerResults::ErrorX };
+				mMarkers.push_back(marker);
+			}
+			i += 2;
+			continue;
+		}
+
+		mEdges[kept] = mEdges[i];
+		mLines[kept] = mLines[i];
+		kept++;
+		i++;
+	}
+
+	mEdges.resize(kept);
+	mLines.resize(kept);
+}
+
+void QSPIWindowDecoder::SaveResults(QSPIParseResult return_value, QSPIFrameType frame_type, U64 data2, U8 flags)
+{
+	if (return_value.start > 0 && return_value.end > 0)
+	{
+		Frame result_frame;
+		result_frame.mStartingSampleInclusive = return_value.start;
+		result_frame.mEndingSampleInclusive = return_value.end;
+		result_frame.mData1 = return_value.data;
+		result_frame.mData2 = data2;
+		result_frame.mType = frame_type;
+		result_frame.mFlags = flags;
+		if (QSPIClockStats::IsUndersampled(TakeShortestPeriod()) == true)
+			result_frame.mFlags |= UNDERSAMPLED_FLAG | DISPLAY_AS_WARNING_FLAG;
+		mFrames.push_back(result_frame);
+	}
+}
+
+void QSPIWindowDecoder::SavePackedData(QSPIParseResult data, int DataLineMask)
+{
+	if (mPendingDataBytes == 0)
+	{
+		mPendingData = data;
+		mPendingDataLines = DataLineMask;
+	}
+	else
+	{
+		mPendingData.end = data.end;
+		mPendingData.data = (mPendingData.data << 8) | data.data;
+	}
+
+	mPendingDataBytes++;
+	if (mPendingDataBytes >= mSettings->mDataBytesPerFrame)
+		FlushPackedData();
+}
+
+void QSPIWindowDecoder::FlushPackedData()
+{
+	if (mPendingDataBytes == 0)
+		return;
+
+	SaveResults(mPendingData, FrameTypeData, mPendingDataBytes | (U64(mPendingDataLines) << 8), PACKED_DATA_FLAG);
+	mPendingDataBytes = 0;
+}
+
+void QSPIWindowDecoder::AbandonTransaction()
+{
+	mEdge = U32(mEdges.size());
+}
+
+QSPIParseResult QSPIWindowDecoder::AbandonField(U32 samples, U32 stride)
+{
+	// mark the sample edges the window still has for this field
+	AddArrowMarkers(std::min<U32>(samples, U32(mEdges.size() - mEdge + stride - 1) / stride), stride, false);
+
+	AbandonTransaction();
+	return{ -1,-1,0 }; // return values for error state
+}
+
+void QSPIWindowDecoder::AddArrowMarkers(U32 samples, U32 stride, bool complete)
+{
+	// same levels as the streaming decoder; the sample points are every stride-th edge from mEdge
+	const U32 detail = mSettings->mMarkerDetail;
+	if ((detail == MarkersOff) || (samples == 0) || ((complete == true) && (detail == MarkersOnErrors)))
+		return;
+
+	Marker marker;
+	marker.mType = complete ? AnalyzerResults::UpArrow : AnalyzerResults::ErrorDot;
+
+	const U32 step = ((detail == MarkersFirstLast) && (samples > 1)) ? samples - 1 : 1;
+	for (U32 i = 0; i < samples; i += step)
+	{
+		marker.mSample = mEdges[mEdge + stride * i];
+		mMarkers.push_back(marker);
+	}
+}
+
+void QSPIWindowDecoder::SaveSfdpByte(U32 address, U8 data)
+{
+	QSPISfdp::Byte byte = { address, data };
+	mSfdpBytes.push_back(byte);
+}
+
+void QSPIWindowDecoder::FinishSfdpRead()
+{
+	// windows may be decoded out of order, so the caller applies mSfdpBytes once the earlier windows are in
+}
@@ -0,0 +1,79 @@
+#ifndef QSPI_WINDOW_DECODER
+#define QSPI_WINDOW_DECODER
+
+#include <AnalyzerResults.h>
+#include <vector>
+#include "QSPIFrameParser.h"
+#include "QSPIEdgeIndex.h"
+#include "QSPIClockStats.h"
+
+// Decodes one chip-select window at a time from a QSPIEdgeIndex into a list of frames. It reads
+// no channel data and touches no analyzer results, so several decoders can work on different
+// windows of the same index at once.
+class QSPIWindowDecoder
+{
+public:
+	struct Marker
+	{
+		U64 mSample;
+		AnalyzerResults::MarkerType mType;
+	};
+
+	QSPIWindowDecoder();
+	~QSPIWindowDecoder();
+
+	void Setup(const QSPIAnalyzerSettings* settings, U64 glitch_samples); // glitch_samples as in QSPIAnalyzer
+	void SetCommands(const QSPICommandSet& commands); // the command set in effect, once SFDP has changed it
+
+	// replaces the frame and marker lists with those of window; the clock polarity is checked by the caller
+	void DecodeWindow(const QSPIEdgeIndex& index, const QSPIEdgeIndex::Window& window);
+	std::vector<Frame>& GetFrames();
+	std::vector<Marker>& GetMarkers(); // sample markers for the clock channel, as set by mMarkerDetail
+	std::vector<QSPISfdp::Byte>& GetSfdpBytes(); // data of the SFDP reads in the window, applied by the caller in window order
+	const QSPIClockStats::Summary& GetClockSummary() const; // over the edges the frames of the window took
+
+protected:
+	template <class DECODER, U32 MODE> friend QSPIParseResult GetQSPIField(DECODER& decoder, int CommandLineMask, U32 num_bits, bool dtr);
+	template <class DECODER, U32 MODE> friend QSPIParseResult GetQSPIDataByte(DECODER& decoder, int DataLineMask, bool dtr);
+	template <class DECODER, U32 MODE, U32 ADDRESS_BYTES> friend void ParseQSPIFrame(DECODER& decoder);
+
+	template <U32 LINE_MASK, bool DTR> QSPIParseResult GetWord(U32 num_bits);
+	template <U32 LINE_MASK, bool DTR> QSPIParseResult GetDataByte();
+	QSPIParseResult GetDummy(U32 cycles);
+	void SaveResults(QSPIParseResult return_value, QSPIFrameType frame_type, U64 data2 = 0, U8 flags = 0);
+	void SavePackedData(QSPIParseResult data, int DataLineMask);
+	void FlushPackedData();
+	void AbandonTransaction();
+	QSPIParseResult AbandonField(U32 samples, U32 stride);
+	void AddArrowMarkers(U32 samples, U32 stride, bool complete);
+	U64 TakeShortestPeriod(); // of the edges taken since the last call
+	void FilterClockGlitches();
+	void SaveSfdpByte(U32 address, U8 data);
+	void FinishSfdpRead();
+
+	const QSPIAnalyzerSettings* mSettings;
+	U64 mGlitchSamples;
+	QSPICommandSet mCommands;
+	QSPIFrameParser<QSPIWindowDecoder>::Parser mFrameParser;
+
+	std::vector<U64> mEdges; // the window being decoded
+	std::vector<U8> mLines;
+	U32 mEdge;
+	U32 mFrameEdge; // first edge not yet in mClockStats, where the next frame starts
+	QSPIClockStats mClockStats;
+	QSPIClockStats::Summary mClockSummary;
+
+	std::vector<U8> mDataBytes; // the data phase, gathered in one go on its first byte
+	U32 mDataByte;
+	U32 mDataEdge; // edge the next byte in mDataBytes starts at
+
+	QSPIParseResult mPendingData; // data bytes collected for the next packed data frame
+	U32 mPendingDataBytes;
+	int mPendingDataLines;
+
+	std::vector<Frame> mFrames;
+	std::vector<Marker> mMarkers;
+	std::vector<QSPISfdp::Byte> mSfdpBytes;
+};
+
+#endif //QSPI_WINDOW_DECODER
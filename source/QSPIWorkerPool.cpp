@@ -0,0 +1,95 @@
+#include "QSPIWorkerPool.h"
+
+QSPIWorkerPool::QSPIWorkerPool()
+:	mTask(NULL),
+	mContext(NULL),
+	mBatch(0),
+	mBatchWorkers(0),
+	mBusyThreads(0),
+	mStopping(false)
+{
+}
+
+QSPIWorkerPool::~QSPIWorkerPool()
+{
+	Stop();
+}
+
+void QSPIWorkerPool::Start(U32 thread_count, Task task, void* context)
+{
+	if ((thread_count != mThreads.size()) || (task != mTask) || (context != mContext))
+	{
+		Stop();
+
+		mTask = task;
+		mContext = context;
+		for (U32 i = 0; i < thread_count; i++)
+			mThreads.push_back(std::thread(&QSPIWorkerPool::ThreadMain, this, i + 1, mBatch));
+	}
+}
+
+void QSPIWorkerPool::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mBatchReady.notify_all();
+
+	for (U32 i = 0; i < mThreads.size(); i++)
+		mThreads[i].join();
+	mThreads.clear();
+
+	mStopping = false;
+}
+
+U32 QSPIWorkerPool::GetWorkerCount() const
+{
+	return U32(mThreads.size()) + 1;
+}
+
+void QSPIWorkerPool::RunBatch(U32 worker_count)
+{
+	if (worker_count > 1)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mBatchWorkers = worker_count;
+			mBusyThreads = worker_count - 1;
+			mBatch++;
+		}
+		mBatchReady.notify_all();
+	}
+
+	mTask(mContext, 0);
+
+	if (worker_count > 1)
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		while (mBusyThreads != 0)
+			mBatchDone.wait(lock);
+	}
+}
+
+void QSPIWorkerPool::ThreadMain(U32 worker, U64 batch)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	for (; ; )
+	{
+		while ((mStopping == false) && (mBatch == batch))
+			mBatchReady.wait(lock);
+		if (mStopping == true)
+			return;
+
+		batch = mBatch;
+		if (worker >= mBatchWorkers)
+			continue; // not needed for this batch
+
+		lock.unlock();
+		mTask(mContext, worker);
+		lock.lock();
+
+		if (--mBusyThreads == 0)
+			mBatchDone.notify_one();
+	}
+}
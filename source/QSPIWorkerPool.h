@@ -0,0 +1,42 @@
+#ifndef QSPI_WORKER_POOL
+#define QSPI_WORKER_POOL
+
+#include <LogicPublicTypes.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Threads that are started once and then run one batch after another. RunBatch runs the task on
+// the calling thread as worker 0 and on pool threads as workers 1 and up, and returns when all of
+// them have finished, so the caller owns the results again without joining anything.
+class QSPIWorkerPool
+{
+public:
+	typedef void (*Task)(void* context, U32 worker);
+
+	QSPIWorkerPool();
+	~QSPIWorkerPool();
+
+	void Start(U32 thread_count, Task task, void* context); // keeps the running threads when nothing changed
+	void Stop();
+	U32 GetWorkerCount() const; // pool threads plus the calling thread
+
+	void RunBatch(U32 worker_count); // at most GetWorkerCount
+
+protected:
+	void ThreadMain(U32 worker, U64 batch); // batch: the last one run before the thread started
+
+	std::vector<std::thread> mThreads;
+	std::mutex mMutex;
+	std::condition_variable mBatchReady;
+	std::condition_variable mBatchDone;
+	Task mTask;
+	void* mContext;
+	U64 mBatch; // counts batches, so each thread runs every batch once
+	U32 mBatchWorkers;
+	U32 mBusyThreads;
+	bool mStopping;
+};
+
+#endif //QSPI_WORKER_POOL
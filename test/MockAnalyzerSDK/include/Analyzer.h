@@ -0,0 +1,86 @@
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+#include "SimulationChannelDescriptor.h"
+#include <map>
+#include <memory>
+
+class AnalyzerChannelData;
+class AnalyzerSettings;
+class AnalyzerResults;
+
+// In-memory stand-in for the SDK analyzer base. A driver loads a capture
+// either from simulation output (LoadSimulationCapture) or from explicit edge
+// lists (SetCaptureChannel), then calls Run(), which sets up results and runs
+// WorkerThread synchronously until the channel data is exhausted.
+class LOGICAPI Analyzer
+{
+public:
+	Analyzer();
+	virtual ~Analyzer();
+	virtual void WorkerThread() = 0;
+
+	//sample_rate: if there are multiple devices attached, and one is faster than the other,
+	//we can sample at the speed of the faster one; and pretend the slower one is the same speed.
+	virtual U32 GenerateSimulationData( U64 newest_sample_requested, U32 sample_rate, SimulationChannelDescriptor** simulation_channels ) = 0;
+	virtual U32 GetMinimumSampleRateHz() = 0; //provide the sample rate required to generate good simulation data
+	virtual const char* GetAnalyzerName() const = 0;
+	virtual bool NeedsRerun() = 0;
+
+	//use, but don't override:
+	void SetAnalyzerSettings( AnalyzerSettings* settings );
+	void KillThread();
+	AnalyzerChannelData* GetAnalyzerChannelData( Channel& channel ); //don't delete this pointer
+	void ReportProgress( U64 sample_number );
+	void SetAnalyzerResults( AnalyzerResults* results );
+	U32 GetSimulationSampleRate();
+	U32 GetSampleRate();
+	U64 GetTriggerSample();
+
+	//don't override, don't use:
+	void CheckIfThreadShouldExit();
+
+public: //mock capture control
+	void SetCaptureSampleRate( U32 sample_rate_hz );
+	void SetCaptureTriggerSample( U64 trigger_sample );
+	void SetCaptureChannel( const Channel& channel, BitState initial_state, const std::vector<U64>& transitions );
+	void LoadSimulationCapture( U64 num_samples );
+	void ClearCapture();
+	bool Run();
+
+	U64 GetProgressReportCount();
+	U64 GetLastReportedProgress();
+
+protected:
+	virtual void SetupResultsInternal();
+
+	struct CaptureChannel
+	{
+		BitState mInitialState;
+		std::vector<U64> mTransitions;
+	};
+
+	AnalyzerSettings* mAnalyzerSettings;
+	AnalyzerResults* mAnalyzerResults;
+	std::map<Channel, CaptureChannel> mCapture;
+	std::map<Channel, AnalyzerChannelData*> mChannelData;
+	U32 mSampleRateHz;
+	U64 mTriggerSample;
+	U64 mLastSample;
+	U64 mProgressReports;
+	U64 mLastProgress;
+};
+
+class LOGICAPI Analyzer2 : public Analyzer
+{
+public:
+	Analyzer2();
+	virtual void SetupResults();
+
+protected:
+	virtual void SetupResultsInternal();
+};
+
+#endif //ANALYZER_H
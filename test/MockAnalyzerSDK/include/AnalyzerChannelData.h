@@ -0,0 +1,54 @@
+#ifndef ANALYZERCHANNELDATA
+#define ANALYZERCHANNELDATA
+
+#include "LogicPublicTypes.h"
+#include <cstddef>
+#include <vector>
+
+// In-memory stand-in for the SDK channel cursor. The channel is an initial
+// level plus a sorted list of transition samples; an edge at sample S means
+// the new level is visible at S. Running past the last transition throws
+// AnalyzerChannelData::EndOfData, which the mock Analyzer::Run treats as the
+// end of the capture (the real SDK blocks and later kills the thread).
+class LOGICAPI AnalyzerChannelData
+{
+public:
+	struct EndOfData {};
+
+	AnalyzerChannelData( BitState initial_state, const std::vector<U64>& transitions, U64 last_sample );
+	~AnalyzerChannelData();
+
+	//State
+	U64 GetSampleNumber();
+	BitState GetBitState();
+
+	//Basic:
+	U32 Advance( U32 num_samples ); //move forward the specified number of samples. Returns the number of times the bit changed state during the move.
+	U32 AdvanceToAbsPosition( U64 sample_number ); //move forward to the specified sample number. Returns the number of times the bit changed state during the move.
+	void AdvanceToNextEdge(); //move forward until the bit state changes from what it is now.
+
+	//Fancier
+	U64 GetSampleOfNextEdge(); //without moving, get the sample of the next transition.
+	bool WouldAdvancingCauseTransition( U32 num_samples ); //if we advanced, would we encounter any transitions?
+	bool WouldAdvancingToAbsPositionCauseTransition( U64 sample_number ); //if we advanced, would we encounter any transitions?
+
+	//minimum pulse tracking.  The serial analyzer uses this for auto-baud
+	void TrackMinimumPulseWidth(); //normally this is not enabled.
+	U64 GetMinimumPulseWidthSoFar();
+
+	//Fancier, part II
+	bool DoMoreTransitionsExistInCurrentData(); //use this when you have a situation where you have multiple lines, and you need to handle the case where one or the other of them may never change again, and you don't know which.
+
+protected:
+	U32 CountTransitionsTo( U64 sample_number );
+
+	BitState mInitialState;
+	std::vector<U64> mTransitions;
+	U64 mLastSample;
+	U64 mSampleNumber;
+	size_t mNextTransition;
+	bool mTrackMinimumPulseWidth;
+	U64 mMinimumPulseWidth;
+};
+
+#endif //ANALYZERCHANNELDATA
@@ -0,0 +1,136 @@
+#ifndef ANALYZER_SETTING_INTERFACE
+#define ANALYZER_SETTING_INTERFACE
+
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+#include <string>
+#include <vector>
+
+enum AnalyzerInterfaceTypeId { INTERFACE_BASE, INTERFACE_CHANNEL, INTERFACE_NUMBER_LIST, INTERFACE_INTEGER, INTERFACE_TEXT, INTERFACE_BOOL };
+
+class LOGICAPI AnalyzerSettingInterface
+{
+public:
+	AnalyzerSettingInterface();
+	virtual ~AnalyzerSettingInterface();
+
+	static void operator delete( void* p );
+	static void* operator new( size_t size );
+	virtual AnalyzerInterfaceTypeId GetType();
+
+	const char* GetToolTip();
+	const char* GetTitle();
+	bool IsDisabled();
+	void SetTitleAndTooltip( const char* title, const char* tooltip );
+
+protected:
+	std::string mTitle;
+	std::string mTooltip;
+	bool mDisabled;
+};
+
+class LOGICAPI AnalyzerSettingInterfaceChannel : public AnalyzerSettingInterface
+{
+public:
+	AnalyzerSettingInterfaceChannel();
+	virtual ~AnalyzerSettingInterfaceChannel();
+	virtual AnalyzerInterfaceTypeId GetType();
+
+	Channel GetChannel();
+	void SetChannel( const Channel& channel );
+	bool GetSelectionOfNoneIsAllowed();
+	void SetSelectionOfNoneIsAllowed( bool is_allowed );
+
+protected:
+	Channel mChannel;
+	bool mSelectionOfNoneIsAllowed;
+};
+
+class LOGICAPI AnalyzerSettingInterfaceNumberList : public AnalyzerSettingInterface
+{
+public:
+	AnalyzerSettingInterfaceNumberList();
+	virtual ~AnalyzerSettingInterfaceNumberList();
+	virtual AnalyzerInterfaceTypeId GetType();
+
+	double GetNumber();
+	void SetNumber( double number );
+
+	U32 GetListboxNumbersCount();
+	double GetListboxNumber( U32 index );
+
+	U32 GetListboxStringsCount();
+	const char* GetListboxString( U32 index );
+
+	U32 GetListboxTooltipsCount();
+	const char* GetListboxTooltip( U32 index );
+
+	void AddNumber( double number, const char* str, const char* tooltip );
+	void ClearNumbers();
+
+protected:
+	double mNumber;
+	std::vector<double> mNumbers;
+	std::vector<std::string> mStrings;
+	std::vector<std::string> mTooltips;
+};
+
+class LOGICAPI AnalyzerSettingInterfaceInteger : public AnalyzerSettingInterface
+{
+public:
+	AnalyzerSettingInterfaceInteger();
+	virtual ~AnalyzerSettingInterfaceInteger();
+	virtual AnalyzerInterfaceTypeId GetType();
+
+	int GetInteger();
+	void SetInteger( int integer );
+
+	int GetMax();
+	int GetMin();
+
+	void SetMax( int max );
+	void SetMin( int min );
+
+protected:
+	int mInteger;
+	int mMin;
+	int mMax;
+};
+
+class LOGICAPI AnalyzerSettingInterfaceText : public AnalyzerSettingInterface
+{
+public:
+	AnalyzerSettingInterfaceText();
+	virtual ~AnalyzerSettingInterfaceText();
+
+	AnalyzerInterfaceTypeId GetType();
+	const char* GetText();
+	void SetText( const char* text );
+
+	enum TextType { NormalText, FilePath, FolderPath };
+	TextType GetTextType();
+	void SetTextType( TextType text_type );
+
+protected:
+	std::string mText;
+	TextType mTextType;
+};
+
+class LOGICAPI AnalyzerSettingInterfaceBool : public AnalyzerSettingInterface
+{
+public:
+	AnalyzerSettingInterfaceBool();
+	virtual ~AnalyzerSettingInterfaceBool();
+	virtual AnalyzerInterfaceTypeId GetType();
+
+	bool GetValue();
+	void SetValue( bool value );
+	const char* GetCheckBoxText();
+	void SetCheckBoxText( const char* text );
+
+protected:
+	bool mValue;
+	std::string mCheckBoxText;
+};
+
+#endif //ANALYZER_SETTING_INTERFACE
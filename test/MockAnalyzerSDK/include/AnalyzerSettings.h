@@ -0,0 +1,52 @@
+#ifndef ANALYZER_SETTINGS
+#define ANALYZER_SETTINGS
+
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+#include "AnalyzerSettingInterface.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class LOGICAPI AnalyzerSettings
+{
+public:
+	AnalyzerSettings();
+	virtual ~AnalyzerSettings();
+
+	//Implement
+	virtual bool SetSettingsFromInterfaces() = 0;
+	virtual void LoadSettings( const char* settings ) = 0;
+	virtual const char* SaveSettings() = 0;
+
+	//Do not override, call from your implementation
+	void ClearChannels();
+	void AddChannel( Channel& channel, const char* channel_label, bool is_used );
+	void SetErrorText( const char* error_text );
+	void AddInterface( AnalyzerSettingInterface* analyzer_setting_interface );
+	void AddExportOption( U32 user_id, const char* menu_text );
+	void AddExportExtension( U32 user_id, const char* extension_description, const char* extension );
+	const char* SetReturnString( const char* str );
+
+	//mock inspection
+	const char* GetErrorText();
+	U32 GetSettingsInterfacesCount();
+	AnalyzerSettingInterface* GetSettingsInterface( U32 index );
+	U32 GetExportOptionsCount();
+
+protected:
+	struct ChannelEntry
+	{
+		Channel mChannel;
+		std::string mLabel;
+		bool mIsUsed;
+	};
+
+	std::vector<ChannelEntry> mChannels;
+	std::vector<AnalyzerSettingInterface*> mInterfaces;
+	std::vector<U32> mExportOptions;
+	std::string mErrorText;
+	std::string mReturnString;
+};
+
+#endif //ANALYZER_SETTINGS
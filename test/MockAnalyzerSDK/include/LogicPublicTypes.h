@@ -0,0 +1,37 @@
+#ifndef LOGIC_PUBLIC_TYPES
+#define LOGIC_PUBLIC_TYPES
+
+#include <cstddef>
+#include <vector>
+
+// Mock of the Saleae AnalyzerSDK public types, for building analyzers off-host.
+
+#ifndef WIN32
+	#define __cdecl
+	#define __stdcall
+	#define __fastcall
+#endif
+
+#define LOGICAPI
+#define ANALYZER_EXPORT
+
+typedef signed char S8;
+typedef short S16;
+typedef int S32;
+typedef long long int S64;
+
+typedef unsigned char U8;
+typedef unsigned short U16;
+typedef unsigned int U32;
+typedef unsigned long long int U64;
+
+#ifndef NULL
+	#define NULL 0
+#endif
+
+enum DisplayBase { Binary, Decimal, Hexadecimal, ASCII, AsciiHex };
+enum BitState { BIT_LOW, BIT_HIGH };
+#define Toggle(x) ( x == BIT_LOW ? BIT_HIGH : BIT_LOW )
+#define Invert(x) ( x == BIT_LOW ? BIT_HIGH : BIT_LOW )
+
+#endif //LOGIC_PUBLIC_TYPES
@@ -0,0 +1,164 @@
+#include "Analyzer.h"
+#include "AnalyzerChannelData.h"
+
+Analyzer::Analyzer()
+:	mAnalyzerSettings( NULL ),
+	mAnalyzerResults( NULL ),
+	mSampleRateHz( 100000000 ),
+	mTriggerSample( 0 ),
+	mLastSample( 0 ),
+	mProgressReports( 0 ),
+	mLastProgress( 0 )
+{
+}
+
+Analyzer::~Analyzer()
+{
+	ClearCapture();
+}
+
+void Analyzer::SetAnalyzerSettings( AnalyzerSettings* settings )
+{
+	mAnalyzerSettings = settings;
+}
+
+void Analyzer::KillThread()
+{
+}
+
+AnalyzerChannelData* Analyzer::GetAnalyzerChannelData( Channel& channel )
+{
+	std::map<Channel, AnalyzerChannelData*>::iterator existing = mChannelData.find( channel );
+	if( existing != mChannelData.end() )
+		return existing->second;
+
+	AnalyzerChannelData* data;
+	std::map<Channel, CaptureChannel>::iterator capture = mCapture.find( channel );
+	if( capture != mCapture.end() )
+		data = new AnalyzerChannelData( capture->second.mInitialState, capture->second.mTransitions, mLastSample );
+	else
+		data = new AnalyzerChannelData( BIT_LOW, std::vector<U64>(), mLastSample );
+
+	mChannelData[ channel ] = data;
+	return data;
+}
+
+void Analyzer::ReportProgress( U64 sample_number )
+{
+	mProgressReports++;
+	mLastProgress = sample_number;
+}
+
+void Analyzer::SetAnalyzerResults( AnalyzerResults* results )
+{
+	mAnalyzerResults = results;
+}
+
+U32 Analyzer::GetSimulationSampleRate()
+{
+	return mSampleRateHz;
+}
+
+U32 Analyzer::GetSampleRate()
+{
+	return mSampleRateHz;
+}
+
+U64 Analyzer::GetTriggerSample()
+{
+	return mTriggerSample;
+}
+
+void Analyzer::CheckIfThreadShouldExit()
+{
+}
+
+void Analyzer::SetCaptureSampleRate( U32 sample_rate_hz )
+{
+	mSampleRateHz = sample_rate_hz;
+}
+
+void Analyzer::SetCaptureTriggerSample( U64 trigger_sample )
+{
+	mTriggerSample = trigger_sample;
+}
+
+void Analyzer::SetCaptureChannel( const Channel& channel, BitState initial_state, const std::vector<U64>& transitions )
+{
+	CaptureChannel& capture = mCapture[ channel ];
+	capture.mInitialState = initial_state;
+	capture.mTransitions = transitions;
+	if( !transitions.empty() && transitions.back() > mLastSample )
+		mLastSample = transitions.back();
+}
+
+void Analyzer::LoadSimulationCapture( U64 num_samples )
+{
+	SimulationChannelDescriptor* channels = NULL;
+	U32 count = GenerateSimulationData( num_samples, mSampleRateHz, &channels );
+
+	for( U32 i = 0; i < count; i++ )
+	{
+		SetCaptureChannel( channels[ i ].GetChannel(), channels[ i ].GetInitialBitState(), channels[ i ].GetTransitions() );
+		if( channels[ i ].GetCurrentSampleNumber() > mLastSample )
+			mLastSample = channels[ i ].GetCurrentSampleNumber();
+	}
+}
+
+void Analyzer::ClearCapture()
+{
+	for( std::map<Channel, AnalyzerChannelData*>::iterator it = mChannelData.begin(); it != mChannelData.end(); ++it )
+		delete it->second;
+	mChannelData.clear();
+	mCapture.clear();
+	mLastSample = 0;
+}
+
+bool Analyzer::Run()
+{
+	for( std::map<Channel, AnalyzerChannelData*>::iterator it = mChannelData.begin(); it != mChannelData.end(); ++it )
+		delete it->second;
+	mChannelData.clear();
+	mProgressReports = 0;
+	mLastProgress = 0;
+
+	SetupResultsInternal();
+
+	try
+	{
+		WorkerThread();
+	}
+	catch( AnalyzerChannelData::EndOfData& )
+	{
+		return true;
+	}
+	return false;
+}
+
+U64 Analyzer::GetProgressReportCount()
+{
+	return mProgressReports;
+}
+
+U64 Analyzer::GetLastReportedProgress()
+{
+	return mLastProgress;
+}
+
+void Analyzer::SetupResultsInternal()
+{
+}
+
+Analyzer2::Analyzer2()
+:	Analyzer()
+{
+}
+
+void Analyzer2::SetupResults()
+{
+}
+
+void Analyzer2::SetupResultsInternal()
+{
+	SetupResults();
+}
@@ -0,0 +1,109 @@
+#include "AnalyzerChannelData.h"
+#include <algorithm>
+
+AnalyzerChannelData::AnalyzerChannelData( BitState initial_state, const std::vector<U64>& transitions, U64 last_sample )
+:	mInitialState( initial_state ),
+	mTransitions( transitions ),
+	mLastSample( last_sample ),
+	mSampleNumber( 0 ),
+	mNextTransition( 0 ),
+	mTrackMinimumPulseWidth( false ),
+	mMinimumPulseWidth( 0xFFFFFFFFFFFFFFFFull )
+{
+	// a transition at sample 0 is just the initial state
+	while( mNextTransition < mTransitions.size() && mTransitions[ mNextTransition ] == 0 )
+	{
+		mInitialState = Toggle( mInitialState );
+		mNextTransition++;
+	}
+}
+
+AnalyzerChannelData::~AnalyzerChannelData()
+{
+}
+
+U64 AnalyzerChannelData::GetSampleNumber()
+{
+	return mSampleNumber;
+}
+
+BitState AnalyzerChannelData::GetBitState()
+{
+	return ( mNextTransition & 1 ) ? Toggle( mInitialState ) : mInitialState;
+}
+
+U32 AnalyzerChannelData::Advance( U32 num_samples )
+{
+	return AdvanceToAbsPosition( mSampleNumber + num_samples );
+}
+
+U32 AnalyzerChannelData::CountTransitionsTo( U64 sample_number )
+{
+	std::vector<U64>::const_iterator it = std::upper_bound( mTransitions.begin() + mNextTransition, mTransitions.end(), sample_number );
+	return U32( ( it - mTransitions.begin() ) - mNextTransition );
+}
+
+U32 AnalyzerChannelData::AdvanceToAbsPosition( U64 sample_number )
+{
+	if( sample_number < mSampleNumber )
+		return 0;
+	if( sample_number > mLastSample )
+		throw EndOfData();
+
+	U32 count = CountTransitionsTo( sample_number );
+	if( mTrackMinimumPulseWidth )
+	{
+		for( U32 i = 0; i < count; i++ )
+		{
+			size_t index = mNextTransition + i;
+			if( index > 0 )
+				mMinimumPulseWidth = std::min( mMinimumPulseWidth, mTransitions[ index ] - mTransitions[ index - 1 ] );
+		}
+	}
+	mNextTransition += count;
+	mSampleNumber = sample_number;
+	return count;
+}
+
+void AnalyzerChannelData::AdvanceToNextEdge()
+{
+	AdvanceToAbsPosition( GetSampleOfNextEdge() );
+}
+
+U64 AnalyzerChannelData::GetSampleOfNextEdge()
+{
+	if( mNextTransition >= mTransitions.size() )
+		throw EndOfData();
+	return mTransitions[ mNextTransition ];
+}
+
+bool AnalyzerChannelData::WouldAdvancingCauseTransition( U32 num_samples )
+{
+	return WouldAdvancingToAbsPositionCauseTransition( mSampleNumber + num_samples );
+}
+
+bool AnalyzerChannelData::WouldAdvancingToAbsPositionCauseTransition( U64 sample_number )
+{
+	if( mNextTransition >= mTransitions.size() )
+	{
+		if( sample_number > mLastSample )
+			throw EndOfData();
+		return false;
+	}
+	return mTransitions[ mNextTransition ] <= sample_number;
+}
+
+void AnalyzerChannelData::TrackMinimumPulseWidth()
+{
+	mTrackMinimumPulseWidth = true;
+}
+
+U64 AnalyzerChannelData::GetMinimumPulseWidthSoFar()
+{
+	return mMinimumPulseWidth;
+}
+
+bool AnalyzerChannelData::DoMoreTransitionsExistInCurrentData()
+{
+	return mNextTransition < mTransitions.size();
+}
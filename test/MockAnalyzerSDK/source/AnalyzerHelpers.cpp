@@ -0,0 +1,388 @@
+#include "AnalyzerHelpers.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+
+bool AnalyzerHelpers::IsEven( U64 value )
+{
+	return ( value & 1 ) == 0;
+}
+
+bool AnalyzerHelpers::IsOdd( U64 value )
+{
+	return ( value & 1 ) != 0;
+}
+
+U32 AnalyzerHelpers::GetOnesCount( U64 value )
+{
+	U32 count = 0;
+	for( ; value != 0; value &= value - 1 )
+		count++;
+	return count;
+}
+
+U32 AnalyzerHelpers::Diff32( U32 a, U32 b )
+{
+	return ( a > b ) ? ( a - b ) : ( b - a );
+}
+
+void AnalyzerHelpers::GetNumberString( U64 number, DisplayBase display_base, U32 num_data_bits, char* result_string, U32 result_string_max_length )
+{
+	if( num_data_bits < 64 )
+		number &= ( 1ull << num_data_bits ) - 1;
+
+	switch( display_base )
+	{
+	case Binary:
+	{
+		std::string bits( "0b" );
+		for( U32 i = num_data_bits; i > 0; i-- )
+			bits += ( ( number >> ( i - 1 ) ) & 1 ) ? '1' : '0';
+		snprintf( result_string, result_string_max_length, "%s", bits.c_str() );
+		break;
+	}
+	case Decimal:
+		snprintf( result_string, result_string_max_length, "%llu", number );
+		break;
+	case ASCII:
+		if( number >= 0x20 && number < 0x7F )
+			snprintf( result_string, result_string_max_length, "%c", char( number ) );
+		else
+			snprintf( result_string, result_string_max_length, "'%llu'", number );
+		break;
+	case AsciiHex:
+		if( number >= 0x20 && number < 0x7F )
+			snprintf( result_string, result_string_max_length, "'%c' (0x%0*llX)", char( number ), int( ( num_data_bits + 3 ) / 4 ), number );
+		else
+			snprintf( result_string, result_string_max_length, "0x%0*llX", int( ( num_data_bits + 3 ) / 4 ), number );
+		break;
+	case Hexadecimal:
+	default:
+		snprintf( result_string, result_string_max_length, "0x%0*llX", int( ( num_data_bits + 3 ) / 4 ), number );
+		break;
+	}
+}
+
+void AnalyzerHelpers::GetTimeString( U64 sample, U64 trigger_sample, U32 sample_rate_hz, char* result_string, U32 result_string_max_length )
+{
+	double time_s = ( double( S64( sample - trigger_sample ) ) ) / double( sample_rate_hz );
+	snprintf( result_string, result_string_max_length, "%.9f", time_s );
+}
+
+void AnalyzerHelpers::Assert( const char* message )
+{
+	throw std::runtime_error( message );
+}
+
+U64 AnalyzerHelpers::AdjustSimulationTargetSample( U64 target_sample, U32 sample_rate, U32 simulation_sample_rate )
+{
+	if( sample_rate == simulation_sample_rate )
+		return target_sample;
+	return U64( double( target_sample ) * double( simulation_sample_rate ) / double( sample_rate ) );
+}
+
+bool AnalyzerHelpers::DoChannelsOverlap( const Channel* channel_array, U32 num_channels )
+{
+	for( U32 i = 0; i < num_channels; i++ )
+	{
+		if( channel_array[ i ] == UNDEFINED_CHANNEL )
+			continue;
+		for( U32 j = i + 1; j < num_channels; j++ )
+			if( channel_array[ i ] == channel_array[ j ] )
+				return true;
+	}
+	return false;
+}
+
+void AnalyzerHelpers::SaveFile( const char* file_name, const U8* data, U32 data_length, bool is_binary )
+{
+	void* f = StartFile( file_name, is_binary );
+	AppendToFile( data, data_length, f );
+	EndFile( f );
+}
+
+S64 AnalyzerHelpers::ConvertToSignedNumber( U64 number, U32 num_bits )
+{
+	if( num_bits == 0 || num_bits >= 64 )
+		return S64( number );
+	U64 sign = 1ull << ( num_bits - 1 );
+	number &= ( 1ull << num_bits ) - 1;
+	return ( number & sign ) ? S64( number ) - S64( 1ull << num_bits ) : S64( number );
+}
+
+void* AnalyzerHelpers::StartFile( const char* file_name, bool is_binary )
+{
+	return std::fopen( file_name, is_binary ? "wb" : "w" );
+}
+
+void AnalyzerHelpers::AppendToFile( const U8* data, U32 data_length, void* file )
+{
+	if( file != NULL )
+		std::fwrite( data, 1, data_length, (FILE*)file );
+}
+
+void AnalyzerHelpers::EndFile( void* file )
+{
+	if( file != NULL )
+		std::fclose( (FILE*)file );
+}
+
+ClockGenerator::ClockGenerator()
+:	mSampleRateHz( 0.0 ),
+	mSamplesPerHalfPeriod( 0.0 ),
+	mCurrentTime( 0.0 ),
+	mCurrentSample( 0 )
+{
+}
+
+ClockGenerator::~ClockGenerator()
+{
+}
+
+void ClockGenerator::Init( double target_frequency, U32 sample_rate_hz )
+{
+	mSampleRateHz = sample_rate_hz;
+	mSamplesPerHalfPeriod = double( sample_rate_hz ) / ( target_frequency * 2.0 );
+	mCurrentTime = 0.0;
+	mCurrentSample = 0;
+}
+
+U32 ClockGenerator::AdvanceByHalfPeriod( double multiple )
+{
+	mCurrentTime += mSamplesPerHalfPeriod * multiple;
+	U64 new_sample = U64( mCurrentTime + 0.5 );
+	U32 delta = U32( new_sample - mCurrentSample );
+	mCurrentSample = new_sample;
+	return delta;
+}
+
+U32 ClockGenerator::AdvanceByTimeS( double time_s )
+{
+	mCurrentTime += time_s * mSampleRateHz;
+	U64 new_sample = U64( mCurrentTime + 0.5 );
+	U32 delta = U32( new_sample - mCurrentSample );
+	mCurrentSample = new_sample;
+	return delta;
+}
+
+BitExtractor::BitExtractor( U64 data, AnalyzerEnums::ShiftOrder shift_order, U32 num_bits )
+:	mData( data ),
+	mShiftOrder( shift_order ),
+	mNumBits( num_bits ),
+	mIndex( 0 )
+{
+	mMask = ( shift_order == AnalyzerEnums::MsbFirst ) ? ( 1ull << ( num_bits - 1 ) ) : 1ull;
+}
+
+BitExtractor::~BitExtractor()
+{
+}
+
+BitState BitExtractor::GetNextBit()
+{
+	BitState bit = ( mData & mMask ) ? BIT_HIGH : BIT_LOW;
+	if( mShiftOrder == AnalyzerEnums::MsbFirst )
+		mMask >>= 1;
+	else
+		mMask <<= 1;
+	mIndex++;
+	return bit;
+}
+
+DataBuilder::DataBuilder()
+:	mData( NULL ),
+	mShiftOrder( AnalyzerEnums::MsbFirst ),
+	mMask( 0 )
+{
+}
+
+DataBuilder::~DataBuilder()
+{
+}
+
+void DataBuilder::Reset( U64* data, AnalyzerEnums::ShiftOrder shift_order, U32 num_bits )
+{
+	mData = data;
+	mShiftOrder = shift_order;
+	*mData = 0;
+	mMask = ( shift_order == AnalyzerEnums::MsbFirst ) ? ( 1ull << ( num_bits - 1 ) ) : 1ull;
+}
+
+void DataBuilder::AddBit( BitState bit )
+{
+	if( bit == BIT_HIGH )
+		*mData |= mMask;
+	if( mShiftOrder == AnalyzerEnums::MsbFirst )
+		mMask >>= 1;
+	else
+		mMask <<= 1;
+}
+
+SimpleArchive::SimpleArchive()
+:	mReadPosition( 0 )
+{
+}
+
+SimpleArchive::~SimpleArchive()
+{
+}
+
+void SimpleArchive::SetString( const char* archive_string )
+{
+	mString = archive_string;
+	mReadPosition = 0;
+}
+
+const char* SimpleArchive::GetString()
+{
+	return mString.c_str();
+}
+
+static std::string ArchiveToken( const std::string& token )
+{
+	char prefix[ 32 ];
+	snprintf( prefix, sizeof( prefix ), "%u:", U32( token.size() ) );
+	return std::string( prefix ) + token + " ";
+}
+
+bool SimpleArchive::operator<<( U64 data )
+{
+	char buf[ 32 ];
+	snprintf( buf, sizeof( buf ), "%llu", data );
+	mString += ArchiveToken( buf );
+	return true;
+}
+
+bool SimpleArchive::operator<<( U32 data )
+{
+	return *this << U64( data );
+}
+
+bool SimpleArchive::operator<<( S64 data )
+{
+	char buf[ 32 ];
+	snprintf( buf, sizeof( buf ), "%lld", data );
+	mString += ArchiveToken( buf );
+	return true;
+}
+
+bool SimpleArchive::operator<<( S32 data )
+{
+	return *this << S64( data );
+}
+
+bool SimpleArchive::operator<<( double data )
+{
+	char buf[ 64 ];
+	snprintf( buf, sizeof( buf ), "%.17g", data );
+	mString += ArchiveToken( buf );
+	return true;
+}
+
+bool SimpleArchive::operator<<( bool data )
+{
+	mString += ArchiveToken( data ? "1" : "0" );
+	return true;
+}
+
+bool SimpleArchive::operator<<( const char* data )
+{
+	mString += ArchiveToken( data );
+	return true;
+}
+
+bool SimpleArchive::operator<<( Channel& data )
+{
+	*this << data.mDeviceId;
+	*this << data.mChannelIndex;
+	*this << U32( data.mDataType );
+	return true;
+}
+
+bool SimpleArchive::ReadToken( std::string& token )
+{
+	size_t colon = mString.find( ':', mReadPosition );
+	if( colon == std::string::npos )
+		return false;
+
+	size_t length = std::strtoul( mString.c_str() + mReadPosition, NULL, 10 );
+	if( colon + 1 + length > mString.size() )
+		return false;
+
+	token = mString.substr( colon + 1, length );
+	mReadPosition = colon + 1 + length + 1;
+	return true;
+}
+
+bool SimpleArchive::operator>>( U64& data )
+{
+	std::string token;
+	if( !ReadToken( token ) )
+		return false;
+	data = std::strtoull( token.c_str(), NULL, 10 );
+	return true;
+}
+
+bool SimpleArchive::operator>>( U32& data )
+{
+	U64 value;
+	if( !( *this >> value ) )
+		return false;
+	data = U32( value );
+	return true;
+}
+
+bool SimpleArchive::operator>>( S64& data )
+{
+	std::string token;
+	if( !ReadToken( token ) )
+		return false;
+	data = std::strtoll( token.c_str(), NULL, 10 );
+	return true;
+}
+
+bool SimpleArchive::operator>>( S32& data )
+{
+	S64 value;
+	if( !( *this >> value ) )
+		return false;
+	data = S32( value );
+	return true;
+}
+
+bool SimpleArchive::operator>>( double& data )
+{
+	std::string token;
+	if( !ReadToken( token ) )
+		return false;
+	data = std::strtod( token.c_str(), NULL );
+	return true;
+}
+
+bool SimpleArchive::operator>>( bool& data )
+{
+	std::string token;
+	if( !ReadToken( token ) )
+		return false;
+	data = token == "1";
+	return true;
+}
+
+bool SimpleArchive::operator>>( char const** data )
+{
+	if( !ReadToken( mReadString ) )
+		return false;
+	*data = mReadString.c_str();
+	return true;
+}
+
+bool SimpleArchive::operator>>( Channel& data )
+{
+	U32 data_type;
+	if( !( *this >> data.mDeviceId ) || !( *this >> data.mChannelIndex ) || !( *this >> data_type ) )
+		return false;
+	data.mDataType = ChannelDataType( data_type );
+	return true;
+}
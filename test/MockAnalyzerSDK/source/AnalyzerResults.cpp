@@ -0,0 +1,222 @@
+#include "AnalyzerResults.h"
+
+Frame::Frame()
+:	mStartingSampleInclusive( 0 ),
+	mEndingSampleInclusive( 0 ),
+	mData1( 0 ),
+	mData2( 0 ),
+	mType( 0 ),
+	mFlags( 0 )
+{
+}
+
+Frame::Frame( const Frame& frame )
+:	mStartingSampleInclusive( frame.mStartingSampleInclusive ),
+	mEndingSampleInclusive( frame.mEndingSampleInclusive ),
+	mData1( frame.mData1 ),
+	mData2( frame.mData2 ),
+	mType( frame.mType ),
+	mFlags( frame.mFlags )
+{
+}
+
+Frame::~Frame()
+{
+}
+
+bool Frame::HasFlag( U8 flag )
+{
+	return ( mFlags & flag ) != 0;
+}
+
+AnalyzerResults::AnalyzerResults()
+:	mPacketStart( 0 ),
+	mCommittedFrames( 0 ),
+	mCommits( 0 )
+{
+}
+
+AnalyzerResults::~AnalyzerResults()
+{
+}
+
+void AnalyzerResults::AddMarker( U64 sample_number, MarkerType marker_type, Channel& channel )
+{
+	Marker marker;
+	marker.mSample = sample_number;
+	marker.mType = marker_type;
+	marker.mChannel = channel;
+	mMarkers.push_back( marker );
+}
+
+U64 AnalyzerResults::AddFrame( const Frame& frame )
+{
+	mFrames.push_back( frame );
+	return mFrames.size() - 1;
+}
+
+U64 AnalyzerResults::CommitPacketAndStartNewPacket()
+{
+	// like the SDK, a packet only exists if it holds at least one frame
+	if( mPacketStart == mFrames.size() )
+		return INVALID_RESULT_INDEX;
+
+	mPacketFirstFrames.push_back( mPacketStart );
+	mPacketStart = mFrames.size();
+	return mPacketFirstFrames.size() - 1;
+}
+
+void AnalyzerResults::CancelPacketAndStartNewPacket()
+{
+	mPacketStart = mFrames.size();
+}
+
+void AnalyzerResults::AddPacketToTransaction( U64 /*transaction_id*/, U64 /*packet_id*/ )
+{
+}
+
+void AnalyzerResults::AddChannelBubblesWillAppearOn( const Channel& channel )
+{
+	mBubbleChannels.push_back( channel );
+}
+
+void AnalyzerResults::CommitResults()
+{
+	mCommittedFrames = mFrames.size();
+	mCommits++;
+}
+
+U64 AnalyzerResults::GetNumFrames()
+{
+	return mCommittedFrames;
+}
+
+U64 AnalyzerResults::GetNumPackets()
+{
+	return mPacketFirstFrames.size();
+}
+
+Frame AnalyzerResults::GetFrame( U64 frame_id )
+{
+	return mFrames.at( frame_id );
+}
+
+U64 AnalyzerResults::GetPacketContainingFrame( U64 frame_id )
+{
+	if( mPacketFirstFrames.empty() || frame_id < mPacketFirstFrames.front() )
+		return INVALID_RESULT_INDEX;
+
+	size_t lo = 0;
+	size_t hi = mPacketFirstFrames.size();
+	while( hi - lo > 1 )
+	{
+		size_t mid = ( lo + hi ) / 2;
+		if( mPacketFirstFrames[ mid ] <= frame_id )
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	U64 last_frame;
+	U64 first_frame;
+	GetFramesContainedInPacket( lo, &first_frame, &last_frame );
+	if( frame_id > last_frame )
+		return INVALID_RESULT_INDEX;
+	return lo;
+}
+
+U64 AnalyzerResults::GetPacketContainingFrameSequential( U64 frame_id )
+{
+	return GetPacketContainingFrame( frame_id );
+}
+
+void AnalyzerResults::GetFramesContainedInPacket( U64 packet_id, U64* first_frame_id, U64* last_frame_id )
+{
+	*first_frame_id = mPacketFirstFrames.at( packet_id );
+	if( packet_id + 1 < mPacketFirstFrames.size() )
+		*last_frame_id = mPacketFirstFrames[ packet_id + 1 ] - 1;
+	else
+		*last_frame_id = mPacketStart - 1;
+}
+
+U32 AnalyzerResults::GetTransactionContainingPacket( U64 /*packet_id*/ )
+{
+	return 0;
+}
+
+void AnalyzerResults::GetPacketsContainedInTransaction( U64 /*transaction_id*/, U64** packet_id_array, U64* packet_id_count )
+{
+	*packet_id_array = NULL;
+	*packet_id_count = 0;
+}
+
+void AnalyzerResults::ClearResultStrings()
+{
+	mResultStrings.clear();
+	mResultStringPointers.clear();
+}
+
+static std::string JoinStrings( const char* str1, const char* str2, const char* str3, const char* str4, const char* str5, const char* str6 )
+{
+	std::string result( str1 );
+	const char* rest[] = { str2, str3, str4, str5, str6 };
+	for( U32 i = 0; i < 5 && rest[ i ] != NULL; i++ )
+		result += rest[ i ];
+	return result;
+}
+
+void AnalyzerResults::AddResultString( const char* str1, const char* str2, const char* str3, const char* str4, const char* str5, const char* str6 )
+{
+	mResultStrings.push_back( JoinStrings( str1, str2, str3, str4, str5, str6 ) );
+}
+
+void AnalyzerResults::GetResultStrings( char const*** result_string_array, U32* num_strings )
+{
+	mResultStringPointers.clear();
+	for( size_t i = 0; i < mResultStrings.size(); i++ )
+		mResultStringPointers.push_back( mResultStrings[ i ].c_str() );
+	*result_string_array = mResultStringPointers.empty() ? NULL : &mResultStringPointers[ 0 ];
+	*num_strings = U32( mResultStringPointers.size() );
+}
+
+void AnalyzerResults::ClearTabularText()
+{
+	mTabularText.clear();
+}
+
+void AnalyzerResults::AddTabularText( const char* str1, const char* str2, const char* str3, const char* str4, const char* str5, const char* str6 )
+{
+	if( !mTabularText.empty() )
+		mTabularText += "\n";
+	mTabularText += JoinStrings( str1, str2, str3, str4, str5, str6 );
+}
+
+const char* AnalyzerResults::GetTabularTextString()
+{
+	return mTabularText.c_str();
+}
+
+bool AnalyzerResults::UpdateExportProgressAndCheckForCancel( U64 /*completed_frames*/, U64 /*total_frames*/ )
+{
+	return false;
+}
+
+U64 AnalyzerResults::GetNumCommittedFrames()
+{
+	return mCommittedFrames;
+}
+
+U64 AnalyzerResults::GetNumCommits()
+{
+	return mCommits;
+}
+
+const std::vector<AnalyzerResults::Marker>& AnalyzerResults::GetMarkers()
+{
+	return mMarkers;
+}
+
+const std::vector<std::string>& AnalyzerResults::GetResultStringList()
+{
+	return mResultStrings;
+}
@@ -0,0 +1,68 @@
+#include "AnalyzerSettings.h"
+
+AnalyzerSettings::AnalyzerSettings()
+{
+}
+
+AnalyzerSettings::~AnalyzerSettings()
+{
+}
+
+void AnalyzerSettings::ClearChannels()
+{
+	mChannels.clear();
+}
+
+void AnalyzerSettings::AddChannel( Channel& channel, const char* channel_label, bool is_used )
+{
+	ChannelEntry entry;
+	entry.mChannel = channel;
+	entry.mLabel = channel_label;
+	entry.mIsUsed = is_used;
+	mChannels.push_back( entry );
+}
+
+void AnalyzerSettings::SetErrorText( const char* error_text )
+{
+	mErrorText = error_text;
+}
+
+void AnalyzerSettings::AddInterface( AnalyzerSettingInterface* analyzer_setting_interface )
+{
+	mInterfaces.push_back( analyzer_setting_interface );
+}
+
+void AnalyzerSettings::AddExportOption( U32 user_id, const char* /*menu_text*/ )
+{
+	mExportOptions.push_back( user_id );
+}
+
+void AnalyzerSettings::AddExportExtension( U32 /*user_id*/, const char* /*extension_description*/, const char* /*extension*/ )
+{
+}
+
+const char* AnalyzerSettings::SetReturnString( const char* str )
+{
+	mReturnString = str;
+	return mReturnString.c_str();
+}
+
+const char* AnalyzerSettings::GetErrorText()
+{
+	return mErrorText.c_str();
+}
+
+U32 AnalyzerSettings::GetSettingsInterfacesCount()
+{
+	return U32( mInterfaces.size() );
+}
+
+AnalyzerSettingInterface* AnalyzerSettings::GetSettingsInterface( U32 index )
+{
+	return mInterfaces.at( index );
+}
+
+U32 AnalyzerSettings::GetExportOptionsCount()
+{
+	return U32( mExportOptions.size() );
+}
@@ -0,0 +1,56 @@
+#include "AnalyzerTypes.h"
+
+Channel::Channel()
+:	mDeviceId( 0xFFFFFFFFFFFFFFFFull ),
+	mChannelIndex( 0xFFFFFFFF ),
+	mDataType( UNDEFINED_CHANNEL_DATA )
+{
+}
+
+Channel::Channel( const Channel& channel )
+:	mDeviceId( channel.mDeviceId ),
+	mChannelIndex( channel.mChannelIndex ),
+	mDataType( channel.mDataType )
+{
+}
+
+Channel::Channel( U64 device_id, U32 channel_index, ChannelDataType data_type )
+:	mDeviceId( device_id ),
+	mChannelIndex( channel_index ),
+	mDataType( data_type )
+{
+}
+
+Channel::~Channel()
+{
+}
+
+Channel& Channel::operator=( const Channel& channel )
+{
+	mDeviceId = channel.mDeviceId;
+	mChannelIndex = channel.mChannelIndex;
+	mDataType = channel.mDataType;
+	return *this;
+}
+
+bool Channel::operator==( const Channel& channel ) const
+{
+	return ( mDeviceId == channel.mDeviceId ) && ( mChannelIndex == channel.mChannelIndex );
+}
+
+bool Channel::operator!=( const Channel& channel ) const
+{
+	return !( *this == channel );
+}
+
+bool Channel::operator>( const Channel& channel ) const
+{
+	return channel < *this;
+}
+
+bool Channel::operator<( const Channel& channel ) const
+{
+	if( mDeviceId != channel.mDeviceId )
+		return mDeviceId < channel.mDeviceId;
+	return mChannelIndex < channel.mChannelIndex;
+}
@@ -0,0 +1,141 @@
+#include "SimulationChannelDescriptor.h"
+
+SimulationChannelDescriptor::SimulationChannelDescriptor()
+:	mSampleRateHz( 0 ),
+	mInitialBitState( BIT_LOW ),
+	mCurrentBitState( BIT_LOW ),
+	mCurrentSample( 0 )
+{
+}
+
+SimulationChannelDescriptor::SimulationChannelDescriptor( const SimulationChannelDescriptor& other )
+:	mChannel( other.mChannel ),
+	mSampleRateHz( other.mSampleRateHz ),
+	mInitialBitState( other.mInitialBitState ),
+	mCurrentBitState( other.mCurrentBitState ),
+	mCurrentSample( other.mCurrentSample ),
+	mTransitions( other.mTransitions )
+{
+}
+
+SimulationChannelDescriptor::~SimulationChannelDescriptor()
+{
+}
+
+SimulationChannelDescriptor& SimulationChannelDescriptor::operator=( const SimulationChannelDescriptor& other )
+{
+	mChannel = other.mChannel;
+	mSampleRateHz = other.mSampleRateHz;
+	mInitialBitState = other.mInitialBitState;
+	mCurrentBitState = other.mCurrentBitState;
+	mCurrentSample = other.mCurrentSample;
+	mTransitions = other.mTransitions;
+	return *this;
+}
+
+void SimulationChannelDescriptor::Transition()
+{
+	mCurrentBitState = Toggle( mCurrentBitState );
+
+	// two transitions on the same sample cancel out
+	if( !mTransitions.empty() && mTransitions.back() == mCurrentSample )
+		mTransitions.pop_back();
+	else
+		mTransitions.push_back( mCurrentSample );
+}
+
+void SimulationChannelDescriptor::TransitionIfNeeded( BitState bit_state )
+{
+	if( bit_state != mCurrentBitState )
+		Transition();
+}
+
+void SimulationChannelDescriptor::Advance( U32 num_samples_to_advance )
+{
+	mCurrentSample += num_samples_to_advance;
+}
+
+BitState SimulationChannelDescriptor::GetCurrentBitState()
+{
+	return mCurrentBitState;
+}
+
+U64 SimulationChannelDescriptor::GetCurrentSampleNumber()
+{
+	return mCurrentSample;
+}
+
+void SimulationChannelDescriptor::SetChannel( Channel& channel )
+{
+	mChannel = channel;
+}
+
+void SimulationChannelDescriptor::SetSampleRate( U32 sample_rate_hz )
+{
+	mSampleRateHz = sample_rate_hz;
+}
+
+void SimulationChannelDescriptor::SetInitialBitState( BitState intial_bit_state )
+{
+	mInitialBitState = intial_bit_state;
+	mCurrentBitState = intial_bit_state;
+}
+
+Channel SimulationChannelDescriptor::GetChannel()
+{
+	return mChannel;
+}
+
+U32 SimulationChannelDescriptor::GetSampleRate()
+{
+	return mSampleRateHz;
+}
+
+BitState SimulationChannelDescriptor::GetInitialBitState()
+{
+	return mInitialBitState;
+}
+
+const std::vector<U64>& SimulationChannelDescriptor::GetTransitions()
+{
+	return mTransitions;
+}
+
+SimulationChannelDescriptorGroup::SimulationChannelDescriptorGroup()
+{
+	// Add() hands out pointers into this vector, so it must never reallocate
+	mChannels.reserve( 64 );
+}
+
+SimulationChannelDescriptorGroup::~SimulationChannelDescriptorGroup()
+{
+}
+
+SimulationChannelDescriptor* SimulationChannelDescriptorGroup::Add( Channel& channel, U32 sample_rate, BitState intial_bit_state )
+{
+	if( channel == UNDEFINED_CHANNEL || mChannels.size() == mChannels.capacity() )
+		return NULL;
+
+	mChannels.push_back( SimulationChannelDescriptor() );
+	SimulationChannelDescriptor* descriptor = &mChannels.back();
+	descriptor->SetChannel( channel );
+	descriptor->SetSampleRate( sample_rate );
+	descriptor->SetInitialBitState( intial_bit_state );
+	return descriptor;
+}
+
+void SimulationChannelDescriptorGroup::AdvanceAll( U32 num_samples_to_advance )
+{
+	for( size_t i = 0; i < mChannels.size(); i++ )
+		mChannels[ i ].Advance( num_samples_to_advance );
+}
+
+SimulationChannelDescriptor* SimulationChannelDescriptorGroup::GetArray()
+{
+	return mChannels.empty() ? NULL : &mChannels[ 0 ];
+}
+
+U32 SimulationChannelDescriptorGroup::GetCount()
+{
+	return U32( mChannels.size() );
+}
@@ -0,0 +1,649 @@
+// Decode test and benchmark, built against the in-memory AnalyzerSDK stand-in in test/MockAnalyzerSDK.
+// For every mode, the analyzer's own simulation data is decoded by each decoder. The frames must be
+// the commands, addresses and data QSPISimulationDataGenerator put in the capture, the edge index
+// and parallel decoders must give the same frames as the streaming one, and each run is timed.
+// The capture is then stretched and one sample pulses are put on the clock, to check that with the
+// clock glitch filter on every decoder drops the same edges and decodes what the clean capture has.
+// Last, the capture is cut in the middle of a chip-select window, and every decoder must still give
+// the frames of that window up to the cut. Separately, program, erase and read traffic is decoded
+// to check the flash image model, and the address index is checked against a linear scan.
+//
+// Build from the repository root:
+//
+//	g++ -std=c++11 -O2 -Wall -Wextra -Wno-deprecated-declarations -I./test/MockAnalyzerSDK/include -I./source source/*.cpp test/MockAnalyzerSDK/source/*.cpp test/QSPIDecodeTest.cpp -o qspi_decode_test -lpthread
+//
+// Usage: qspi_decode_test [samples per capture] [runs]
+
+#include "QSPIAnalyzer.h"
+#include "QSPIAnalyzerSettings.h"
+#include "QSPIAnalyzerResults.h"
+#include "QSPISfdp.h"
+#include "QSPIAddressIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+enum CaptureShape { CaptureAsIs, CaptureStretched, CaptureGlitched, CaptureTruncated };
+
+class QSPITestAnalyzer : public QSPIAnalyzer
+{
+public:
+	QSPIAnalyzerSettings* GetSettings() { return mSettings.get(); }
+	QSPIAnalyzerResults* GetResults() { return mResults.get(); }
+
+	// Stretches every channel by STRETCH so each clock level is at least that many samples long,
+	// and with glitch_interval puts a one sample pulse in the middle of every glitch_interval-th
+	// clock level. Returns the number of pulses.
+	U64 StretchCapture( const Channel& clock, U32 glitch_interval )
+	{
+		U64 glitches = 0;
+		for( std::map<Channel, CaptureChannel>::iterator it = mCapture.begin(); it != mCapture.end(); ++it )
+		{
+			std::vector<U64>& transitions = it->second.mTransitions;
+			std::vector<U64> stretched;
+			stretched.reserve( transitions.size() * 2 );
+			for( size_t i = 0; i < transitions.size(); i++ )
+			{
+				stretched.push_back( transitions[ i ] * STRETCH );
+				if( ( glitch_interval != 0 ) && ( it->first == clock ) && ( i + 1 < transitions.size() ) && ( i % glitch_interval == 0 ) )
+				{
+					U64 middle = ( transitions[ i ] + transitions[ i + 1 ] ) * STRETCH / 2;
+					stretched.push_back( middle );
+					stretched.push_back( middle + 1 );
+					glitches++;
+				}
+			}
+			transitions.swap( stretched );
+		}
+		mLastSample *= STRETCH;
+		return glitches;
+	}
+
+	// Cuts every channel in the middle of the longest window of the enable line, so the capture ends
+	// with the enable still active. Returns the start of that window and the last sample left.
+	void TruncateCapture( const Channel& enable, U64& window_start, U64& last_sample )
+	{
+		const CaptureChannel& enable_capture = mCapture[ enable ];
+		const std::vector<U64>& edges = enable_capture.mTransitions;
+		size_t first_start = ( enable_capture.mInitialState == BIT_LOW ) ? 1 : 0; // the active-going edges
+		size_t longest = first_start;
+		for( size_t i = first_start; i + 1 < edges.size(); i += 2 )
+			if( edges[ i + 1 ] - edges[ i ] > edges[ longest + 1 ] - edges[ longest ] )
+				longest = i;
+
+		window_start = edges[ longest ];
+		last_sample = ( edges[ longest ] + edges[ longest + 1 ] ) / 2;
+		for( std::map<Channel, CaptureChannel>::iterator it = mCapture.begin(); it != mCapture.end(); ++it )
+		{
+			std::vector<U64>& transitions = it->second.mTransitions;
+			transitions.erase( std::upper_bound( transitions.begin(), transitions.end(), last_sample ), transitions.end() );
+		}
+		mLastSample = last_sample;
+	}
+
+	enum { STRETCH = 8 };
+};
+
+struct DecodeRun
+{
+	std::vector<Frame> mFrames;
+	U64 mPackets;
+	U64 mErrorMarkers;
+	U64 mCutWindowStart; // CaptureTruncated: the window the capture ends in, and its last sample
+	U64 mLastSample;
+	size_t mFirstUnexpectedFrame; // mFrames.size() when every frame is one the simulation put in the capture
+	double mSeconds; // fastest of the runs
+};
+
+// Walks the frames along the transactions QSPISimulationDataGenerator makes: the listed commands in
+// turn, at address 0xBEADED with the data DE AD BE EF, except extended mode reads, which return one
+// 0xAA byte, and SFDP reads, which read the SFDP table from address 0. The simulation starts with
+// the enable already low, so the first transaction has no enable edge and is not decoded; the
+// check starts at the first decoded command. The capture can end part way through a transaction.
+class SimulationChecker
+{
+public:
+	SimulationChecker( const QSPIAnalyzerSettings* settings, const std::vector<Frame>& frames )
+	:	mSettings( settings ),
+		mFrames( frames ),
+		mFrame( 0 )
+	{
+	}
+
+	size_t FindFirstUnexpectedFrame()
+	{
+		const QSPICommandSet& commands = mSettings->mCommands;
+		const U64 command_count = std::min<U64>( 40, commands.GetCount() );
+		const U8 data[] = { 0xDE, 0xAD, 0xBE, 0xEF };
+
+		U64 i = 0;
+		while( ( i < command_count ) && ( mFrames.empty() == false ) && ( commands.GetCommand( i ) != mFrames[ 0 ].mData1 ) )
+			i++;
+		if( i == command_count )
+			return 0;
+
+		for( ; mFrame < mFrames.size(); i = ( i + 1 ) % command_count )
+		{
+			const U64 command = commands.GetCommand( i );
+			const CommandAttr& attr = commands.GetAttr( command );
+			if( Expect( FrameTypeCommand, command ) == false )
+				return mFrame;
+
+			if( attr.AcceptsAddr == true )
+			{
+				const U32 address_bytes = attr.AddressBytes ? attr.AddressBytes : mSettings->mAddressSize;
+				const U64 address = ( command == SFDP_READ_OPCODE ) ? 0 : ( 0xBEADED & ( ( U64( 1 ) << ( 8 * address_bytes ) ) - 1 ) );
+				if( Expect( FrameTypeAddress, address ) == false )
+					return mFrame;
+			}
+
+			if( ( attr.UsesDummyCycles == true ) && ( Expect( FrameTypeDummy, 0 ) == false ) )
+				return mFrame;
+
+			if( attr.HasData == false )
+				continue;
+			if( command == SFDP_READ_OPCODE )
+			{
+				while( ( mFrame < mFrames.size() ) && ( mFrames[ mFrame ].mType == FrameTypeData ) )
+					mFrame++;
+			}
+			else if( ( mSettings->mModeState == ModeStateExtended ) && ( attr.isWrite == false ) )
+			{
+				if( Expect( FrameTypeData, 0xAA ) == false )
+					return mFrame;
+			}
+			else
+			{
+				for( U32 b = 0; b < sizeof( data ); b++ )
+					if( Expect( FrameTypeData, data[ b ] ) == false )
+						return mFrame;
+			}
+		}
+		return mFrames.size();
+	}
+
+protected:
+	bool Expect( U8 type, U64 data ) // true past the last frame, dummy frames hold no data
+	{
+		if( mFrame == mFrames.size() )
+			return true;
+		const Frame& frame = mFrames[ mFrame ];
+		if( ( frame.mType != type ) || ( ( type != FrameTypeDummy ) && ( frame.mData1 != data ) ) )
+			return false;
+		mFrame++;
+		return true;
+	}
+
+	const QSPIAnalyzerSettings* mSettings;
+	const std::vector<Frame>& mFrames;
+	size_t mFrame;
+};
+
+static bool FramesMatch( const Frame& a, const Frame& b )
+{
+	return ( a.mStartingSampleInclusive == b.mStartingSampleInclusive ) && ( a.mEndingSampleInclusive == b.mEndingSampleInclusive ) &&
+		   ( a.mData1 == b.mData1 ) && ( a.mData2 == b.mData2 ) && ( a.mType == b.mType ) && ( a.mFlags == b.mFlags );
+}
+
+static void Decode( U32 mode, U32 decoder, U64 sample_count, U32 runs, DecodeRun& result, CaptureShape shape = CaptureAsIs )
+{
+	result.mSeconds = 0.0;
+
+	for( U32 r = 0; r < runs; r++ )
+	{
+		QSPITestAnalyzer analyzer;
+		QSPIAnalyzerSettings* settings = analyzer.GetSettings();
+		settings->mEnableChannel = Channel( 0, 0 );
+		settings->mClockChannel = Channel( 0, 1 );
+		settings->mDQ0Channel = Channel( 0, 2 );
+		settings->mDQ1Channel = Channel( 0, 3 );
+		settings->mDQ2Channel = Channel( 0, 4 );
+		settings->mDQ3Channel = Channel( 0, 5 );
+		// the octal data commands of the table use DQ4-7 in the other modes too
+		settings->mDQ4Channel = Channel( 0, 6 );
+		settings->mDQ5Channel = Channel( 0, 7 );
+		settings->mDQ6Channel = Channel( 0, 8 );
+		settings->mDQ7Channel = Channel( 0, 9 );
+		settings->mModeState = mode;
+		settings->mDecoder = decoder;
+		if( ( shape == CaptureStretched ) || ( shape == CaptureGlitched ) )
+		{
+			// 10 ns at 100 MHz drops pulses of up to one sample, the stretched clock's levels are longer
+			settings->mClockGlitchFilter = 10;
+			settings->mMarkerDetail = MarkersOnErrors;
+		}
+		settings->UpdateInterfacesFromSettings();
+
+		analyzer.SetCaptureSampleRate( 100000000 );
+		analyzer.LoadSimulationCapture( sample_count );
+		if( ( shape == CaptureStretched ) || ( shape == CaptureGlitched ) )
+			analyzer.StretchCapture( settings->mClockChannel, ( shape == CaptureGlitched ) ? 7 : 0 );
+		if( shape == CaptureTruncated )
+			analyzer.TruncateCapture( settings->mEnableChannel, result.mCutWindowStart, result.mLastSample );
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		analyzer.Run();
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+		double seconds = std::chrono::duration<double>( end - start ).count();
+		if( ( r == 0 ) || ( seconds < result.mSeconds ) )
+			result.mSeconds = seconds;
+
+		if( r == 0 )
+		{
+			QSPIAnalyzerResults* results = analyzer.GetResults();
+			U64 frame_count = results->GetNumFrames();
+			result.mFrames.clear();
+			result.mFrames.reserve( frame_count );
+			for( U64 f = 0; f < frame_count; f++ )
+				result.mFrames.push_back( results->GetFrame( f ) );
+			result.mPackets = results->GetNumPackets();
+			result.mFirstUnexpectedFrame = SimulationChecker( settings, result.mFrames ).FindFirstUnexpectedFrame();
+
+			const std::vector<AnalyzerResults::Marker>& markers = results->GetMarkers();
+			result.mErrorMarkers = 0;
+			for( size_t i = 0; i < markers.size(); i++ )
+				if( markers[ i ].mType == AnalyzerResults::ErrorX )
+					result.mErrorMarkers++;
+		}
+	}
+}
+
+// Extended SPI traffic built bit by bit: enable, clock, DQ0 and DQ1 on channels 0 to 3. The
+// command, the 3 byte address and program data go out on DQ0 and read data comes back on DQ1,
+// one bit every 4 samples with the clock rising in the middle of the bit.
+class SpiTraffic
+{
+public:
+	SpiTraffic()
+	:	mSample( 100 )
+	{
+		mLevels[ ENABLE ] = true;
+		mLevels[ CLOCK ] = mLevels[ DQ0 ] = mLevels[ DQ1 ] = false;
+	}
+
+	void AddTransaction( U8 command, bool has_address, U32 address, const U8* data, U32 count, bool read )
+	{
+		Set( ENABLE, false );
+		mSample += 2;
+		AddByte( command, DQ0 );
+		for( U32 b = 0; has_address && ( b < 3 ); b++ )
+			AddByte( U8( address >> ( 16 - 8 * b ) ), DQ0 );
+		for( U32 b = 0; b < count; b++ )
+			AddByte( data[ b ], read ? DQ1 : DQ0 );
+		mSample += 2;
+		Set( DQ0, false );
+		Set( DQ1, false );
+		Set( ENABLE, true );
+		mSample += 20;
+	}
+
+	void Load( QSPITestAnalyzer& analyzer ) const
+	{
+		for( U32 line = 0; line < LINE_COUNT; line++ )
+			analyzer.SetCaptureChannel( Channel( 0, line ), ( line == ENABLE ) ? BIT_HIGH : BIT_LOW, mTransitions[ line ] );
+	}
+
+protected:
+	enum { ENABLE, CLOCK, DQ0, DQ1, LINE_COUNT };
+
+	void Set( U32 line, bool level )
+	{
+		if( mLevels[ line ] == level )
+			return;
+		mTransitions[ line ].push_back( mSample );
+		mLevels[ line ] = level;
+	}
+
+	void AddByte( U8 value, U32 line )
+	{
+		for( U32 bit = 8; bit-- > 0; )
+		{
+			Set( line, ( ( value >> bit ) & 0x01 ) != 0 );
+			mSample += 2;
+			Set( CLOCK, true );
+			mSample += 2;
+			Set( CLOCK, false );
+		}
+	}
+
+	U64 mSample;
+	bool mLevels[ LINE_COUNT ];
+	std::vector<U64> mTransitions[ LINE_COUNT ];
+};
+
+// The flash image against program, erase and read traffic: the reads that should disagree with
+// the image must carry FLASH_MISMATCH_FLAG and no others, and the image must end up as expected.
+static int CheckFlashImage()
+{
+	struct Access
+	{
+		U8 mCommand;
+		U32 mAddress;
+		U32 mCount;
+		U8 mData[ 4 ];
+		bool mMismatch;
+	};
+	const Access accesses[] = {
+		{ 0x02, 0x1000, 2, { 0x3C, 0x5A }, false }, // program into a page nothing has touched
+		{ 0x03, 0x1000, 2, { 0x3C, 0x5A }, false },
+		{ 0x02, 0x1000, 1, { 0xF0 }, false }, // a second program only clears bits
+		{ 0x03, 0x1000, 1, { 0x30 }, false },
+		{ 0x03, 0x1000, 1, { 0x3C }, true },
+		{ 0x03, 0x1800, 1, { 0x77 }, false }, // the first read of an unknown byte tells what it holds
+		{ 0x03, 0x1800, 1, { 0x76 }, true },
+		{ 0x20, 0x2000, 0, { 0 }, false }, // two erased sectors share the erased page
+		{ 0x20, 0x5000, 0, { 0 }, false },
+		{ 0x02, 0x2010, 1, { 0x0F }, false }, // which the first program copies
+		{ 0x03, 0x2010, 1, { 0x0F }, false },
+		{ 0x03, 0x2011, 1, { 0x00 }, true }, // and keeps the rest of the page known to be erased
+		{ 0x03, 0x5010, 1, { 0xFF }, false },
+		{ 0x03, 0x5011, 1, { 0x0F }, true }, // erased bytes are known
+		{ 0x02, 0x30FE, 4, { 0x01, 0x02, 0x03, 0x04 }, false }, // wraps within the 256 byte program page
+		{ 0x03, 0x30FE, 2, { 0x01, 0x02 }, false },
+		{ 0x03, 0x3000, 2, { 0x03, 0x04 }, false },
+		{ 0x03, 0x3100, 1, { 0x03 }, false }, // untouched by the wrapped program
+		{ 0xC7, 0, 0, { 0 }, false }, // chip erase: every page is erased, listed or not
+		{ 0x03, 0x1000, 1, { 0xFF }, false },
+		{ 0x03, 0x80000, 2, { 0xFF, 0x12 }, true },
+	};
+	const U32 access_count = sizeof( accesses ) / sizeof( accesses[ 0 ] );
+
+	SpiTraffic traffic;
+	for( U32 i = 0; i < access_count; i++ )
+		traffic.AddTransaction( accesses[ i ].mCommand, accesses[ i ].mCommand != 0xC7, accesses[ i ].mAddress, accesses[ i ].mData,
+								accesses[ i ].mCount, accesses[ i ].mCommand == 0x03 );
+
+	QSPITestAnalyzer analyzer;
+	QSPIAnalyzerSettings* settings = analyzer.GetSettings();
+	settings->mEnableChannel = Channel( 0, 0 );
+	settings->mClockChannel = Channel( 0, 1 );
+	settings->mDQ0Channel = Channel( 0, 2 );
+	settings->mDQ1Channel = Channel( 0, 3 );
+	settings->mModeState = ModeStateExtended;
+	settings->mAddressSize = 3;
+	settings->UpdateInterfacesFromSettings();
+
+	analyzer.SetCaptureSampleRate( 100000000 );
+	traffic.Load( analyzer );
+	analyzer.Run();
+
+	// the transactions in order, one command frame each
+	QSPIAnalyzerResults* results = analyzer.GetResults();
+	std::vector<bool> mismatches;
+	for( U64 f = 0; f < results->GetNumFrames(); f++ )
+	{
+		Frame frame = results->GetFrame( f );
+		if( frame.mType == FrameTypeCommand )
+			mismatches.push_back( false );
+		else if( ( frame.mType == FrameTypeData ) && ( ( frame.mFlags & FLASH_MISMATCH_FLAG ) != 0 ) && ( mismatches.empty() == false ) )
+			mismatches.back() = true;
+	}
+
+	int result = 0;
+	if( mismatches.size() != access_count )
+	{
+		printf( "flash image: %zu transactions decoded, %u sent\n", mismatches.size(), access_count );
+		result = 1;
+	}
+	for( U32 i = 0; ( result == 0 ) && ( i < access_count ); i++ )
+	{
+		if( mismatches[ i ] != accesses[ i ].mMismatch )
+		{
+			printf( "flash image: transaction %u at 0x%X %s\n", i, accesses[ i ].mAddress, accesses[ i ].mMismatch ? "not flagged" : "flagged" );
+			result = 1;
+		}
+	}
+
+	// after the chip erase, programmed and read bytes alike are erased
+	U8 bytes[ 2 ];
+	const U64 erased_addresses[] = { 0x1000, 0x30FE, 0x80000 };
+	for( U32 i = 0; i < sizeof( erased_addresses ) / sizeof( erased_addresses[ 0 ] ); i++ )
+	{
+		results->GetFlashImage( erased_addresses[ i ], 2, bytes );
+		if( ( bytes[ 0 ] != 0xFF ) || ( bytes[ 1 ] != 0xFF ) )
+		{
+			printf( "flash image: 0x%llX not erased\n", erased_addresses[ i ] );
+			result = 1;
+		}
+	}
+
+	printf( "flash image %zu transactions  %s\n", mismatches.size(), ( result == 0 ) ? "ok" : "FAILED" );
+	return result;
+}
+
+// Random ranges and queries against a linear scan. The ranges are added in batches with queries in
+// between, so every batch after the first rebuilds the tree over ranges it has already sorted.
+static int CheckAddressIndex()
+{
+	const U32 batch_sizes[] = { 1, 300, 700, 2 };
+	const U32 queries_per_batch = 500;
+
+	QSPIAddressIndex index;
+	std::vector<U64> starts;
+	std::vector<U64> ends;
+	std::vector<U64> found;
+	std::vector<U64> expected;
+	U32 seed = 12345;
+	U32 query_count = 0;
+	int result = 0;
+
+	for( U32 b = 0; ( result == 0 ) && ( b < sizeof( batch_sizes ) / sizeof( batch_sizes[ 0 ] ) ); b++ )
+	{
+		for( U32 i = 0; i < batch_sizes[ b ]; i++ )
+		{
+			// mostly short reads and programs, some 4 KB to 64 KB erases
+			seed = seed * 1103515245 + 12345;
+			const U64 start = ( seed >> 8 ) % 0x40000;
+			seed = seed * 1103515245 + 12345;
+			const U64 length = ( ( seed >> 8 ) % 8 == 0 ) ? ( 0x1000 << ( ( seed >> 12 ) % 5 ) ) : 1 + ( seed >> 12 ) % 0x200;
+			index.AddRange( start, start + length, starts.size() );
+			starts.push_back( start );
+			ends.push_back( start + length );
+		}
+
+		for( U32 q = 0; ( result == 0 ) && ( q < queries_per_batch ); q++ )
+		{
+			seed = seed * 1103515245 + 12345;
+			const U64 start = ( seed >> 8 ) % 0x42000;
+			seed = seed * 1103515245 + 12345;
+			const U64 end = start + ( seed >> 8 ) % 0x800; // an empty query now and then
+			index.FindTransactions( start, end, found );
+
+			expected.clear();
+			for( U64 t = 0; t < starts.size(); t++ )
+				if( ( start < end ) && ( starts[ t ] < end ) && ( ends[ t ] > start ) )
+					expected.push_back( t );
+
+			if( found != expected )
+			{
+				printf( "address index: 0x%llX to 0x%llX after %zu ranges found %zu transactions, %zu expected\n", start, end, starts.size(), found.size(), expected.size() );
+				result = 1;
+			}
+			query_count++;
+		}
+	}
+
+	printf( "address index %zu ranges, %u queries  %s\n", starts.size(), query_count, ( result == 0 ) ? "ok" : "FAILED" );
+	return result;
+}
+
+int main( int argc, char* argv[] )
+{
+	U64 sample_count = ( argc > 1 ) ? strtoull( argv[ 1 ], NULL, 10 ) : 10000000;
+	U32 runs = ( argc > 2 ) ? U32( strtoul( argv[ 2 ], NULL, 10 ) ) : 3;
+	if( runs == 0 )
+		runs = 1;
+
+	const U32 modes[] = { ModeStateExtended, ModeStateDual, ModeStateQuad, ModeStateOctal };
+	const char* mode_names[] = { "extended", "dual", "quad", "octal" };
+	const U32 decoders[] = { DecoderStreaming, DecoderEdgeIndex, DecoderParallel };
+	const char* decoder_names[] = { "streaming", "edge index", "parallel" };
+
+	int result = 0;
+	for( U32 m = 0; m < sizeof( modes ) / sizeof( modes[ 0 ] ); m++ )
+	{
+		DecodeRun reference;
+		for( U32 d = 0; d < sizeof( decoders ) / sizeof( decoders[ 0 ] ); d++ )
+		{
+			DecodeRun run;
+			Decode( modes[ m ], decoders[ d ], sample_count, runs, run );
+
+			const char* status = "ok";
+			if( run.mFrames.empty() == true )
+			{
+				status = "FAILED: no frames";
+				result = 1;
+			}
+			else if( run.mFirstUnexpectedFrame != run.mFrames.size() )
+			{
+				printf( "%s %s: frame %zu is not what the simulation sent\n", mode_names[ m ], decoder_names[ d ], run.mFirstUnexpectedFrame );
+				status = "FAILED";
+				result = 1;
+			}
+			else if( ( d != 0 ) && ( run.mFrames.size() != reference.mFrames.size() ) )
+			{
+				status = "FAILED: frame count differs from streaming";
+				result = 1;
+			}
+			else if( d != 0 )
+			{
+				for( size_t f = 0; f < run.mFrames.size(); f++ )
+				{
+					if( FramesMatch( run.mFrames[ f ], reference.mFrames[ f ] ) == false )
+					{
+						printf( "%s %s: frame %zu differs from streaming\n", mode_names[ m ], decoder_names[ d ], f );
+						status = "FAILED";
+						result = 1;
+						break;
+					}
+				}
+			}
+
+			printf( "%-8s %-10s %8zu frames %6llu packets %9.2f ms %8.1f MS/s  %s\n", mode_names[ m ], decoder_names[ d ], run.mFrames.size(),
+					run.mPackets, run.mSeconds * 1e3, double( sample_count ) / run.mSeconds / 1e6, status );
+
+			if( d == 0 )
+				reference.mFrames.swap( run.mFrames );
+		}
+	}
+
+	// Clock glitches: every decoder must give the frames of the stretched capture without glitches,
+	// and flag the same glitches. A frame that ends just before a glitch can end on it instead, so
+	// only the frame contents are compared with the clean capture.
+	for( U32 m = 0; m < sizeof( modes ) / sizeof( modes[ 0 ] ); m++ )
+	{
+		DecodeRun clean;
+		Decode( modes[ m ], DecoderStreaming, sample_count, 1, clean, CaptureStretched );
+
+		DecodeRun reference;
+		for( U32 d = 0; d < sizeof( decoders ) / sizeof( decoders[ 0 ] ); d++ )
+		{
+			DecodeRun run;
+			Decode( modes[ m ], decoders[ d ], sample_count, 1, run, CaptureGlitched );
+
+			const char* status = "ok";
+			if( run.mErrorMarkers <= clean.mErrorMarkers )
+			{
+				status = "FAILED: no glitches flagged";
+				result = 1;
+			}
+			else if( run.mFrames.size() != clean.mFrames.size() )
+			{
+				status = "FAILED: frame count differs from the capture without glitches";
+				result = 1;
+			}
+			else if( ( d != 0 ) && ( run.mErrorMarkers != reference.mErrorMarkers ) )
+			{
+				status = "FAILED: glitches flagged differ from streaming";
+				result = 1;
+			}
+			else
+			{
+				for( size_t f = 0; f < run.mFrames.size(); f++ )
+				{
+					const Frame& a = run.mFrames[ f ];
+					const Frame& b = clean.mFrames[ f ];
+					bool same = ( a.mData1 == b.mData1 ) && ( a.mData2 == b.mData2 ) && ( a.mType == b.mType ) && ( a.mFlags == b.mFlags );
+					if( ( same == true ) && ( d != 0 ) )
+						same = FramesMatch( a, reference.mFrames[ f ] );
+					if( same == false )
+					{
+						printf( "%s %s glitched: frame %zu differs\n", mode_names[ m ], decoder_names[ d ], f );
+						status = "FAILED";
+						result = 1;
+						break;
+					}
+				}
+			}
+
+			printf( "%-8s %-10s %8llu glitches flagged  %s\n", mode_names[ m ], decoder_names[ d ], run.mErrorMarkers - clean.mErrorMarkers, status );
+
+			if( d == 0 )
+			{
+				reference.mErrorMarkers = run.mErrorMarkers;
+				reference.mFrames.swap( run.mFrames );
+			}
+		}
+	}
+
+	// Capture ending with chip select active: the frames up to the cut are those of the whole
+	// capture, including the ones of the cut window.
+	for( U32 m = 0; m < sizeof( modes ) / sizeof( modes[ 0 ] ); m++ )
+	{
+		DecodeRun whole;
+		Decode( modes[ m ], DecoderStreaming, sample_count, 1, whole );
+
+		for( U32 d = 0; d < sizeof( decoders ) / sizeof( decoders[ 0 ] ); d++ )
+		{
+			DecodeRun run;
+			Decode( modes[ m ], decoders[ d ], sample_count, 1, run, CaptureTruncated );
+
+			size_t expected = 0;
+			size_t in_cut_window = 0;
+			while( ( expected < whole.mFrames.size() ) && ( U64( whole.mFrames[ expected ].mEndingSampleInclusive ) <= run.mLastSample ) )
+			{
+				if( U64( whole.mFrames[ expected ].mStartingSampleInclusive ) >= run.mCutWindowStart )
+					in_cut_window++;
+				expected++;
+			}
+
+			const char* status = "ok";
+			if( in_cut_window == 0 )
+			{
+				status = "FAILED: no frames in the cut window";
+				result = 1;
+			}
+			else if( run.mFrames.size() != expected )
+			{
+				status = "FAILED: frame count differs from the whole capture";
+				result = 1;
+			}
+			else
+			{
+				for( size_t f = 0; f < run.mFrames.size(); f++ )
+				{
+					if( FramesMatch( run.mFrames[ f ], whole.mFrames[ f ] ) == false )
+					{
+						printf( "%s %s truncated: frame %zu differs\n", mode_names[ m ], decoder_names[ d ], f );
+						status = "FAILED";
+						result = 1;
+						break;
+					}
+				}
+			}
+
+			printf( "%-8s %-10s %8zu frames, %zu in the cut window  %s\n", mode_names[ m ], decoder_names[ d ], run.mFrames.size(), in_cut_window, status );
+		}
+	}
+
+	if( CheckFlashImage() != 0 )
+		result = 1;
+	if( CheckAddressIndex() != 0 )
+		result = 1;
+
+	return result;
+}